@@ -0,0 +1,275 @@
+#pragma once
+
+#include "helper.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace evqovv
+{
+namespace utils
+{
+namespace allocator_detail
+{
+[[nodiscard]] inline ::std::size_t page_size() noexcept
+{
+    static const auto size = static_cast<::std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+template <typename T>
+[[nodiscard]] ::std::size_t page_rounded_bytes(::std::size_t n)
+{
+    if (n > ::std::numeric_limits<::std::size_t>::max() / sizeof(T)) [[unlikely]]
+    {
+        throw ::std::bad_array_new_length();
+    }
+
+    auto page = page_size();
+    auto bytes = n * sizeof(T);
+    return (bytes + page - 1) / page * page;
+}
+
+inline constexpr ::std::size_t huge_page_size = ::std::size_t(2) << 20;
+
+template <typename T>
+[[nodiscard]] ::std::size_t huge_page_rounded_bytes(::std::size_t n)
+{
+    if (n > (::std::numeric_limits<::std::size_t>::max() - huge_page_size) / sizeof(T)) [[unlikely]]
+    {
+        throw ::std::bad_array_new_length();
+    }
+
+    return (n * sizeof(T) + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+// Maps bytes (a multiple of huge_page_size) at a huge-page aligned address.
+// Explicit huge pages from the hugetlbfs pool are tried first; when the pool
+// is empty the mapping is made of normal pages and marked for transparent
+// huge pages instead.
+[[nodiscard]] inline void *map_huge_pages(::std::size_t bytes)
+{
+    auto p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+    {
+        return p;
+    }
+
+    // Over-map by one huge page and trim both ends so the kernel can back the
+    // range with whole huge pages.
+    auto raw = ::mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) [[unlikely]]
+    {
+        throw ::std::bad_alloc();
+    }
+
+    auto first = reinterpret_cast<::std::uintptr_t>(raw);
+    auto aligned = (first + huge_page_size - 1) & ~(huge_page_size - 1);
+    auto head = aligned - first;
+    auto tail = huge_page_size - head;
+    if (head != 0)
+    {
+        ::munmap(raw, head);
+    }
+
+    if (tail != 0)
+    {
+        ::munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+    }
+
+    p = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+    ::madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+} // namespace allocator_detail
+
+// Aligns every block to Align bytes (a cache line by default), so the first
+// element of a buffer never straddles a cache line and aligned SIMD loads can
+// be used on it.
+template <typename T, ::std::size_t Align = 64>
+class aligned_allocator
+{
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of two.");
+    static_assert(Align >= alignof(T), "Align must not be weaker than alignof(T).");
+
+public:
+    using value_type = T;
+
+    static constexpr ::std::size_t alignment = Align;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        if (n > ::std::numeric_limits<::std::size_t>::max() / sizeof(T)) [[unlikely]]
+        {
+            throw ::std::bad_array_new_length();
+        }
+
+        return static_cast<T *>(::operator new(n * sizeof(T), ::std::align_val_t(Align)));
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        ::operator delete(p, n * sizeof(T), ::std::align_val_t(Align));
+    }
+};
+
+template <typename T, typename U, ::std::size_t Align>
+bool operator==(const aligned_allocator<T, Align> &, const aligned_allocator<U, Align> &) noexcept
+{
+    return true;
+}
+
+// Backs large blocks with 2 MiB pages to cut TLB misses on random access
+// into big buffers. Blocks of at least Threshold bytes are mapped with
+// MAP_HUGETLB, falling back to a huge-page aligned mapping advised with
+// MADV_HUGEPAGE; smaller blocks come from operator new, where huge pages
+// would only waste memory.
+template <typename T, ::std::size_t Threshold = allocator_detail::huge_page_size>
+class huge_page_allocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = huge_page_allocator<U, Threshold>;
+    };
+
+    huge_page_allocator() noexcept = default;
+
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U, Threshold> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        if (!is_huge(n))
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T), ::std::align_val_t(alignof(T))));
+        }
+
+        return static_cast<T *>(allocator_detail::map_huge_pages(allocator_detail::huge_page_rounded_bytes<T>(n)));
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        if (!is_huge(n))
+        {
+            ::operator delete(p, n * sizeof(T), ::std::align_val_t(alignof(T)));
+            return;
+        }
+
+        if (::munmap(p, allocator_detail::huge_page_rounded_bytes<T>(n)) != 0) [[unlikely]]
+        {
+            terminate();
+        }
+    }
+
+private:
+    [[nodiscard]] static constexpr bool is_huge(::std::size_t n) noexcept
+    {
+        return n >= (Threshold + sizeof(T) - 1) / sizeof(T);
+    }
+};
+
+template <typename T, typename U, ::std::size_t Threshold>
+bool operator==(const huge_page_allocator<T, Threshold> &, const huge_page_allocator<U, Threshold> &) noexcept
+{
+    return true;
+}
+
+// Allocates every block with its own anonymous mapping. Meant for large
+// buffers: growing goes through mremap, which extends the mapping in place or
+// moves its pages without copying, so vector can grow huge trivially
+// relocatable buffers without touching every page or holding two copies.
+template <typename T>
+class mmap_allocator
+{
+public:
+    using value_type = T;
+
+    mmap_allocator() noexcept = default;
+
+    template <typename U>
+    mmap_allocator(const mmap_allocator<U> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        auto p = ::mmap(nullptr, allocator_detail::page_rounded_bytes<T>(n), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) [[unlikely]]
+        {
+            throw ::std::bad_alloc();
+        }
+
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        if (::munmap(p, allocator_detail::page_rounded_bytes<T>(n)) != 0) [[unlikely]]
+        {
+            terminate();
+        }
+    }
+
+    [[nodiscard]] bool try_expand(T *p, ::std::size_t old_n, ::std::size_t new_n)
+    {
+        auto old_bytes = allocator_detail::page_rounded_bytes<T>(old_n);
+        auto new_bytes = allocator_detail::page_rounded_bytes<T>(new_n);
+        if (new_bytes <= old_bytes)
+        {
+            return true;
+        }
+
+        return ::mremap(p, old_bytes, new_bytes, 0) != MAP_FAILED;
+    }
+
+    [[nodiscard]] T *reallocate(T *p, ::std::size_t old_n, ::std::size_t new_n)
+    {
+        auto old_bytes = allocator_detail::page_rounded_bytes<T>(old_n);
+        auto new_bytes = allocator_detail::page_rounded_bytes<T>(new_n);
+        if (new_bytes == old_bytes)
+        {
+            return p;
+        }
+
+        auto new_p = ::mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (new_p == MAP_FAILED) [[unlikely]]
+        {
+            throw ::std::bad_alloc();
+        }
+
+        return static_cast<T *>(new_p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const mmap_allocator<T> &, const mmap_allocator<U> &) noexcept
+{
+    return true;
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
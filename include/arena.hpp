@@ -0,0 +1,268 @@
+#pragma once
+
+#include "helper.hpp"
+#include "unique_ptr.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace evqovv
+{
+namespace utils
+{
+// A monotonic arena: allocation bumps a pointer through a chain of blocks and
+// individual deallocation is a no-op (except for the most recent allocation,
+// which is rewound). reset() rewinds the arena to its first byte in O(1)
+// while keeping every block for reuse; release() also returns the heap blocks.
+// Neither runs destructors, so objects that own resources must be destroyed
+// before the arena is rewound.
+//
+// The arena can start on a caller-provided buffer, e.g. one on the stack, and
+// only touches the heap once that is exhausted.
+class arena
+{
+    struct block
+    {
+        block *next;
+        ::std::size_t size;
+    };
+
+    static constexpr ::std::size_t header_size =
+        (sizeof(block) + alignof(::std::max_align_t) - 1) / alignof(::std::max_align_t) * alignof(::std::max_align_t);
+
+public:
+    static constexpr ::std::size_t default_block_size = 64 * 1024;
+
+    explicit arena(::std::size_t block_size = default_block_size) noexcept : block_size_(block_size)
+    {
+    }
+
+    arena(void *buffer, ::std::size_t size, ::std::size_t block_size = default_block_size) noexcept
+        : initial_(static_cast<unsigned char *>(buffer)), initial_size_(size), cur_(initial_),
+          end_(initial_ + size), block_size_(block_size)
+    {
+    }
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    arena(arena &&) = delete;
+    arena &operator=(arena &&) = delete;
+
+    ~arena()
+    {
+        release();
+    }
+
+    [[nodiscard]] void *allocate(::std::size_t bytes, ::std::size_t align = alignof(::std::max_align_t))
+    {
+        auto cur = reinterpret_cast<::std::uintptr_t>(cur_);
+        auto padding = (align - (cur & (align - 1))) & (align - 1);
+        if (padding + bytes <= static_cast<::std::size_t>(end_ - cur_)) [[likely]]
+        {
+            auto p = cur_ + padding;
+            cur_ = p + bytes;
+            return p;
+        }
+
+        return allocate_slow(bytes, align);
+    }
+
+    // Only the most recent allocation gives its bytes back.
+    void deallocate(void *p, ::std::size_t bytes) noexcept
+    {
+        if (static_cast<unsigned char *>(p) + bytes == cur_)
+        {
+            cur_ = static_cast<unsigned char *>(p);
+        }
+    }
+
+    // Rewinds to the start of the first block. The heap blocks stay chained
+    // and are reused by later allocations.
+    void reset() noexcept
+    {
+        current_ = nullptr;
+        if (initial_)
+        {
+            cur_ = initial_;
+            end_ = initial_ + initial_size_;
+        }
+        else
+        {
+            cur_ = nullptr;
+            end_ = nullptr;
+        }
+    }
+
+    // Rewinds and frees all heap blocks.
+    void release() noexcept
+    {
+        for (auto b = head_; b;)
+        {
+            auto next = b->next;
+            ::operator delete(b, header_size + b->size);
+            b = next;
+        }
+
+        head_ = nullptr;
+        reset();
+    }
+
+private:
+    [[nodiscard]] static unsigned char *block_data(block *b) noexcept
+    {
+        return reinterpret_cast<unsigned char *>(b) + header_size;
+    }
+
+    // Moves on to the next retained block that fits, or chains a new one
+    // behind the current block.
+    [[nodiscard]] void *allocate_slow(::std::size_t bytes, ::std::size_t align)
+    {
+        if (bytes > ::std::numeric_limits<::std::size_t>::max() - header_size - align) [[unlikely]]
+        {
+            throw ::std::bad_alloc();
+        }
+
+        auto needed = bytes + (align > alignof(::std::max_align_t) ? align : 0);
+
+        auto next = current_ ? current_->next : head_;
+        while (next && next->size < needed)
+        {
+            next = next->next;
+        }
+
+        if (!next)
+        {
+            auto size = needed < block_size_ ? block_size_ : needed;
+            next = static_cast<block *>(::operator new(header_size + size));
+            next->size = size;
+            if (current_)
+            {
+                next->next = current_->next;
+                current_->next = next;
+            }
+            else
+            {
+                next->next = head_;
+                head_ = next;
+            }
+        }
+
+        current_ = next;
+        cur_ = block_data(next);
+        end_ = cur_ + next->size;
+        return allocate(bytes, align);
+    }
+
+    unsigned char *initial_{};
+
+    ::std::size_t initial_size_{};
+
+    unsigned char *cur_{};
+
+    unsigned char *end_{};
+
+    block *head_{};
+
+    block *current_{};
+
+    ::std::size_t block_size_{};
+};
+
+// An arena whose initial buffer of N bytes lives inside the object.
+template <::std::size_t N>
+class inline_arena : public arena
+{
+public:
+    explicit inline_arena(::std::size_t block_size = default_block_size) noexcept
+        : arena(buffer_, N, block_size)
+    {
+    }
+
+private:
+    alignas(::std::max_align_t) unsigned char buffer_[N];
+};
+
+// Allocator handing out memory from an arena, e.g. for vector<T,
+// arena_allocator<T>>. Copies share the arena, which must outlive them.
+template <typename T>
+class arena_allocator
+{
+    template <typename U>
+    friend class arena_allocator;
+
+public:
+    using value_type = T;
+
+    explicit arena_allocator(arena &a) noexcept : arena_(::std::addressof(a))
+    {
+    }
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : arena_(other.arena_)
+    {
+    }
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        if (n > ::std::numeric_limits<::std::size_t>::max() / sizeof(T)) [[unlikely]]
+        {
+            throw ::std::bad_array_new_length();
+        }
+
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    [[nodiscard]] arena *resource() const noexcept
+    {
+        return arena_;
+    }
+
+    template <typename U>
+    friend bool operator==(const arena_allocator &lhs, const arena_allocator<U> &rhs) noexcept
+    {
+        return lhs.resource() == rhs.resource();
+    }
+
+private:
+    arena *arena_;
+};
+
+// Deleter for objects created in an arena: runs the destructor and leaves the
+// memory to the arena. Being empty, it keeps unique_ptr pointer-sized.
+template <typename T>
+struct arena_deleter
+{
+    constexpr arena_deleter() noexcept = default;
+
+    template <typename Tx>
+        requires ::std::convertible_to<Tx *, T *>
+    arena_deleter(const arena_deleter<Tx> &) noexcept
+    {
+    }
+
+    void operator()(T *p) noexcept
+    {
+        p->~T();
+    }
+};
+
+template <typename T>
+using arena_ptr = unique_ptr<T, arena_deleter<T>>;
+
+template <typename T, typename... Args>
+    requires(!::std::is_array_v<T>)
+arena_ptr<T> make_arena_unique(arena &a, Args &&...args)
+{
+    auto p = a.allocate(sizeof(T), alignof(T));
+    return arena_ptr<T>(::new (p) T(::std::forward<Args>(args)...));
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
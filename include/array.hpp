@@ -1,6 +1,7 @@
 #pragma once
 
 #include "helper.hpp"
+#include <array>
 #include <cassert>
 #include <compare>
 #include <iterator>
@@ -29,20 +30,14 @@ struct array
 
     constexpr reference operator[](size_type pos)
     {
-        if (pos >= N) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(pos < N);
 
         return eles_[pos];
     }
 
     [[nodiscard]] constexpr const_reference operator[](size_type pos) const
     {
-        if (pos >= N) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(pos < N);
 
         return eles_[pos];
     }
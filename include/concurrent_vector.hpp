@@ -0,0 +1,286 @@
+#pragma once
+
+#include "helper.hpp"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace evqovv
+{
+namespace utils
+{
+// An append-only vector that many threads can grow at once without a lock.
+// Indices are claimed with one fetch_add; storage is a fixed directory of
+// segments whose sizes double, allocated on first use and published with a
+// compare-exchange, so elements never move. A segment stores its elements
+// contiguously, followed by an array of published flags that are set after
+// construction; readers may access an element from any thread once
+// is_published(i) is true, or when the index was handed over by the producing
+// thread.
+//
+// If allocation or construction throws, the claimed index stays unpublished.
+template <typename T, typename Alloc = ::std::allocator<T>, ::std::size_t FirstSegmentSize = 64>
+class concurrent_vector
+{
+    static_assert(FirstSegmentSize != 0 && (FirstSegmentSize & (FirstSegmentSize - 1)) == 0,
+                  "FirstSegmentSize must be a power of two.");
+
+    using alloc_traits_t = ::std::allocator_traits<Alloc>;
+    using flag_type = ::std::atomic<bool>;
+
+    static constexpr ::std::size_t first_shift = ::std::countr_zero(FirstSegmentSize);
+    static constexpr ::std::size_t max_segments = ::std::numeric_limits<::std::size_t>::digits - first_shift;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+
+    explicit concurrent_vector(const Alloc &alloc) noexcept : alloc_(alloc)
+    {
+    }
+
+    concurrent_vector() noexcept(noexcept(Alloc())) : concurrent_vector(Alloc())
+    {
+    }
+
+    concurrent_vector(const concurrent_vector &) = delete;
+    concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+    concurrent_vector(concurrent_vector &&) = delete;
+    concurrent_vector &operator=(concurrent_vector &&) = delete;
+
+    ~concurrent_vector()
+    {
+        clear();
+
+        for (size_type k = 0; k != max_segments; ++k)
+        {
+            auto seg = segments_[k].load(::std::memory_order_relaxed);
+            if (seg)
+            {
+                alloc_traits_t::deallocate(alloc_, seg, allocation_size(k));
+            }
+        }
+    }
+
+    // Appends an element and returns its index. Safe to call concurrently.
+    template <typename... Args>
+    size_type emplace_back(Args &&...args)
+    {
+        auto i = size_.fetch_add(1, ::std::memory_order_relaxed);
+        construct(i, ::std::forward<Args>(args)...);
+        return i;
+    }
+
+    size_type push_back(const T &value)
+    {
+        return emplace_back(value);
+    }
+
+    size_type push_back(T &&value)
+    {
+        return emplace_back(::std::move(value));
+    }
+
+    // Appends count value-initialized elements and returns the index of the
+    // first one. Safe to call concurrently.
+    size_type grow_by(size_type count)
+    {
+        auto first = size_.fetch_add(count, ::std::memory_order_relaxed);
+        for (auto i = first; i != first + count; ++i)
+        {
+            construct(i);
+        }
+
+        return first;
+    }
+
+    size_type grow_by(size_type count, const T &value)
+    {
+        auto first = size_.fetch_add(count, ::std::memory_order_relaxed);
+        for (auto i = first; i != first + count; ++i)
+        {
+            construct(i, value);
+        }
+
+        return first;
+    }
+
+    [[nodiscard]] bool is_published(size_type pos) const noexcept
+    {
+        if (pos >= size()) [[unlikely]]
+        {
+            return false;
+        }
+
+        auto [k, offset] = locate(pos);
+        auto seg = segments_[k].load(::std::memory_order_acquire);
+        return seg && flags(seg, k)[offset].load(::std::memory_order_acquire);
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        if (!is_published(pos)) [[unlikely]]
+        {
+            terminate();
+        }
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        if (!is_published(pos)) [[unlikely]]
+        {
+            terminate();
+        }
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos) noexcept
+    {
+        auto [k, offset] = locate(pos);
+        return segments_[k].load(::std::memory_order_acquire)[offset];
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const noexcept
+    {
+        auto [k, offset] = locate(pos);
+        return segments_[k].load(::std::memory_order_acquire)[offset];
+    }
+
+    // Number of claimed indices, including elements still being constructed.
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_.load(::std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        size_type cap = 0;
+        for (size_type k = 0; k != max_segments; ++k)
+        {
+            if (segments_[k].load(::std::memory_order_acquire))
+            {
+                cap += segment_size(k);
+            }
+        }
+
+        return cap;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    // Destroys all elements but keeps the segments. Not thread-safe.
+    void clear() noexcept
+    {
+        auto n = size_.load(::std::memory_order_relaxed);
+        for (size_type i = 0; i != n; ++i)
+        {
+            auto [k, offset] = locate(i);
+            auto seg = segments_[k].load(::std::memory_order_relaxed);
+            if (seg && flags(seg, k)[offset].load(::std::memory_order_relaxed))
+            {
+                alloc_traits_t::destroy(alloc_, seg + offset);
+                flags(seg, k)[offset].store(false, ::std::memory_order_relaxed);
+            }
+        }
+
+        size_.store(0, ::std::memory_order_relaxed);
+    }
+
+private:
+    struct position
+    {
+        size_type segment;
+        size_type offset;
+    };
+
+    [[nodiscard]] static constexpr size_type segment_size(size_type k) noexcept
+    {
+        return FirstSegmentSize << k;
+    }
+
+    // Segment k covers the indices whose value plus FirstSegmentSize lies in
+    // [FirstSegmentSize << k, FirstSegmentSize << (k + 1)).
+    [[nodiscard]] static constexpr position locate(size_type pos) noexcept
+    {
+        auto biased = pos + FirstSegmentSize;
+        auto k = static_cast<size_type>(::std::bit_width(biased)) - 1 - first_shift;
+        return {k, biased - segment_size(k)};
+    }
+
+    // The flags live in extra T-sized units at the end of the segment's
+    // allocation, so the elements stay densely packed and producers publishing
+    // neighbouring indices do not write into the elements' cache lines.
+    [[nodiscard]] static constexpr size_type allocation_size(size_type k) noexcept
+    {
+        auto n = segment_size(k);
+        return n + (n * sizeof(flag_type) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    [[nodiscard]] static flag_type *flags(T *seg, size_type k) noexcept
+    {
+        return ::std::launder(reinterpret_cast<flag_type *>(seg + segment_size(k)));
+    }
+
+    [[nodiscard]] T *segment(size_type k)
+    {
+        auto seg = segments_[k].load(::std::memory_order_acquire);
+        if (seg) [[likely]]
+        {
+            return seg;
+        }
+
+        auto n = segment_size(k);
+        auto fresh = alloc_traits_t::allocate(alloc_, allocation_size(k));
+        auto published = reinterpret_cast<unsigned char *>(fresh + n);
+        for (size_type i = 0; i != n; ++i)
+        {
+            ::new (static_cast<void *>(published + i * sizeof(flag_type))) flag_type(false);
+        }
+
+        if (segments_[k].compare_exchange_strong(seg, fresh, ::std::memory_order_acq_rel,
+                                                 ::std::memory_order_acquire))
+        {
+            return fresh;
+        }
+
+        alloc_traits_t::deallocate(alloc_, fresh, allocation_size(k));
+        return seg;
+    }
+
+    template <typename... Args>
+    void construct(size_type pos, Args &&...args)
+    {
+        auto [k, offset] = locate(pos);
+        auto seg = segment(k);
+        alloc_traits_t::construct(alloc_, seg + offset, ::std::forward<Args>(args)...);
+        flags(seg, k)[offset].store(true, ::std::memory_order_release);
+    }
+
+    ::std::atomic<T *> segments_[max_segments]{};
+
+    alignas(64) ::std::atomic<size_type> size_{0};
+
+    [[no_unique_address]] Alloc alloc_{};
+};
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
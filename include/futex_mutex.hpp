@@ -0,0 +1,129 @@
+#pragma once
+
+#include "helper.hpp"
+#include "lock_profiling.hpp"
+#include <atomic>
+#include <cstdint>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace evqovv
+{
+namespace utils
+{
+namespace futex_detail
+{
+// Sleeps while word still holds expected. Spurious returns (EINTR, EAGAIN
+// when the value already changed) are left to the caller's retry loop.
+inline void wait(::std::atomic<::std::uint32_t> &word, ::std::uint32_t expected) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<::std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr,
+              0);
+}
+
+inline void wake(::std::atomic<::std::uint32_t> &word, int count) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<::std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+} // namespace futex_detail
+
+// A mutex in a single 32-bit word that parks on a futex. The word is 0 when
+// unlocked, 1 when locked and 2 when locked with possible sleepers, so an
+// uncontended lock and unlock are one atomic instruction each and unlock only
+// enters the kernel if someone may be waiting. A contended lock spins briefly
+// first, since critical sections are often shorter than a sleep and wake-up.
+//
+// Unlike mutex, it never fails and never throws. Linux only.
+class futex_mutex
+{
+public:
+    futex_mutex(const futex_mutex &) = delete;
+    futex_mutex &operator=(const futex_mutex &) = delete;
+
+    futex_mutex(futex_mutex &&) = delete;
+    futex_mutex &operator=(futex_mutex &&) = delete;
+
+    constexpr futex_mutex() noexcept = default;
+
+    // Profiled under name when EVQOVV_UTILS_LOCK_PROFILING is defined.
+    explicit futex_mutex(const char *name) : probe_(name)
+    {
+    }
+
+    void lock() noexcept
+    {
+        probe_.acquire([this] { return try_acquire(); }, [this] { acquire(); });
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        return probe_.try_acquire([this] { return try_acquire(); });
+    }
+
+    void unlock() noexcept
+    {
+        probe_.release();
+        if (state_.exchange(unlocked, ::std::memory_order_release) == contended) [[unlikely]]
+        {
+            futex_detail::wake(state_, 1);
+        }
+    }
+
+private:
+    static constexpr ::std::uint32_t unlocked = 0;
+    static constexpr ::std::uint32_t locked = 1;
+    static constexpr ::std::uint32_t contended = 2;
+
+    static constexpr int spin_count = 100;
+
+    [[nodiscard]] bool try_acquire() noexcept
+    {
+        auto c = unlocked;
+        return state_.compare_exchange_strong(c, locked, ::std::memory_order_acquire, ::std::memory_order_relaxed);
+    }
+
+    void acquire() noexcept
+    {
+        if (try_acquire()) [[likely]]
+        {
+            return;
+        }
+
+        lock_slow(state_.load(::std::memory_order_relaxed));
+    }
+
+    void lock_slow(::std::uint32_t c) noexcept
+    {
+        // Once there are sleepers, spinning only delays joining them.
+        for (int i = 0; i != spin_count && c != contended; ++i)
+        {
+            cpu_relax();
+            c = state_.load(::std::memory_order_relaxed);
+            if (c == unlocked &&
+                state_.compare_exchange_weak(c, locked, ::std::memory_order_acquire, ::std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+
+        // Whoever takes the lock from here on marks it contended, since it
+        // cannot know whether other threads are still asleep.
+        c = state_.exchange(contended, ::std::memory_order_acquire);
+        while (c != unlocked)
+        {
+            futex_detail::wait(state_, contended);
+            c = state_.exchange(contended, ::std::memory_order_acquire);
+        }
+    }
+
+    ::std::atomic<::std::uint32_t> state_{unlocked};
+
+    [[no_unique_address]] lock_profiling_detail::lock_probe probe_;
+};
+
+#ifndef EVQOVV_UTILS_LOCK_PROFILING
+static_assert(sizeof(futex_mutex) == 4);
+#endif
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <system_error>
+#include <type_traits>
 
 namespace evqovv
 {
@@ -30,10 +31,78 @@ inline constexpr void assert_condition(bool condition) noexcept
     }
 }
 
+// Selects the precondition checks of operator[], front, back and pop_back in
+// all containers. Define EVQOVV_UTILS_BOUNDS_CHECK to one of these before
+// including any header; the default checks always. With DEBUG the checks are
+// compiled out under NDEBUG, with NEVER they are gone, so operator[] becomes
+// plain indexing that the compiler can vectorize.
+#define EVQOVV_UTILS_BOUNDS_CHECK_NEVER 0
+#define EVQOVV_UTILS_BOUNDS_CHECK_DEBUG 1
+#define EVQOVV_UTILS_BOUNDS_CHECK_ALWAYS 2
+
+#ifndef EVQOVV_UTILS_BOUNDS_CHECK
+#define EVQOVV_UTILS_BOUNDS_CHECK EVQOVV_UTILS_BOUNDS_CHECK_ALWAYS
+#endif
+
+#if EVQOVV_UTILS_BOUNDS_CHECK == EVQOVV_UTILS_BOUNDS_CHECK_ALWAYS ||                                                  \
+    (EVQOVV_UTILS_BOUNDS_CHECK == EVQOVV_UTILS_BOUNDS_CHECK_DEBUG && !defined(NDEBUG))
+inline constexpr bool bounds_checked = true;
+#else
+inline constexpr bool bounds_checked = false;
+#endif
+
+inline constexpr void check_bounds([[maybe_unused]] bool in_bounds) noexcept
+{
+    if constexpr (bounds_checked)
+    {
+        if (!in_bounds) [[unlikely]]
+        {
+            terminate();
+        }
+    }
+}
+
+// Tells the CPU that the caller is busy-waiting, which saves power and frees
+// execution resources for the sibling hyperthread.
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
 [[noreturn]] inline void throw_system_exception(const char *what)
 {
     throw std::system_error(errno, std::generic_category(), what);
 }
 
+[[noreturn]] inline void throw_system_exception(int error, const char *what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+// Tag selecting default-initialization instead of value-initialization, so
+// trivially constructible elements are left indeterminate rather than zeroed.
+struct for_overwrite_t
+{
+    explicit for_overwrite_t() = default;
+};
+
+inline constexpr for_overwrite_t for_overwrite{};
+
+// A type is trivially relocatable when moving an object to a new address and
+// destroying the source is equivalent to copying its bytes and forgetting the
+// source. Containers use this to grow with a single memcpy. Trivially copyable
+// types qualify automatically; other types opt in by specializing the trait.
+template <typename T>
+struct is_trivially_relocatable : ::std::is_trivially_copyable<T>
+{
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<::std::remove_cv_t<T>>::value;
+
 } // namespace utils
 } // namespace evqovv
\ No newline at end of file
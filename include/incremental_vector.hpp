@@ -0,0 +1,524 @@
+#pragma once
+
+#include "vector.hpp"
+
+namespace evqovv
+{
+namespace utils
+{
+// A vector for very large element counts that never stalls on growth. When
+// the buffer fills up, a new block is allocated but the existing elements stay
+// in the old one; every following modification migrates at most
+// migration_step() of them, like an incremental rehash. While a migration is
+// in progress the elements are split across two blocks, so there is no
+// contiguous view: data() first finishes the migration.
+//
+// Migration completes before the next growth as long as the growth policy
+// leaves room for old_size / migration_step() appends; otherwise the rest is
+// migrated at once when the new block fills up.
+template <typename T, typename Alloc = ::std::allocator<T>, typename GrowthPolicy = default_growth>
+class incremental_vector
+{
+    using atraits_t = ::std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = typename atraits_t::size_type;
+    using difference_type = typename atraits_t::difference_type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = typename atraits_t::pointer;
+    using const_pointer = typename atraits_t::const_pointer;
+
+    static constexpr size_type default_migration_step = 1024;
+
+    explicit incremental_vector(size_type migration_step, const Alloc &alloc = Alloc()) noexcept
+        : step_(migration_step < 2 ? 2 : migration_step), alloc_(alloc)
+    {
+    }
+
+    explicit incremental_vector(const Alloc &alloc) noexcept : incremental_vector(default_migration_step, alloc)
+    {
+    }
+
+    incremental_vector() noexcept(noexcept(Alloc())) : incremental_vector(Alloc())
+    {
+    }
+
+    incremental_vector(const incremental_vector &other)
+        : incremental_vector(other.step_, atraits_t::select_on_container_copy_construction(other.alloc_))
+    {
+        if (other.size_ == 0)
+        {
+            return;
+        }
+
+        vector_detail::raw_memory raw(alloc_, other.size_);
+        uninitialized_copy_from(other, raw.get());
+        data_ = raw.release();
+        size_ = other.size_;
+        cap_ = other.size_;
+    }
+
+    incremental_vector(incremental_vector &&other) noexcept
+        : data_(::std::exchange(other.data_, nullptr)), size_(::std::exchange(other.size_, 0)),
+          cap_(::std::exchange(other.cap_, 0)), old_(::std::exchange(other.old_, nullptr)),
+          old_size_(::std::exchange(other.old_size_, 0)), old_cap_(::std::exchange(other.old_cap_, 0)),
+          migrated_(::std::exchange(other.migrated_, 0)), step_(other.step_), alloc_(::std::move(other.alloc_))
+    {
+    }
+
+    ~incremental_vector()
+    {
+        destroy_and_deallocate();
+    }
+
+    incremental_vector &operator=(const incremental_vector &other)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_copy_assignment::value)
+        {
+            destroy_and_deallocate();
+            data_ = nullptr;
+            cap_ = 0;
+            alloc_ = other.alloc_;
+        }
+
+        clear();
+        step_ = other.step_;
+        if (cap_ < other.size_)
+        {
+            vector_detail::raw_memory raw(alloc_, other.size_);
+            uninitialized_copy_from(other, raw.get());
+            replace_buffer(raw.release(), other.size_);
+        }
+        else
+        {
+            uninitialized_copy_from(other, data_);
+        }
+
+        size_ = other.size_;
+
+        return *this;
+    }
+
+    incremental_vector &operator=(incremental_vector &&other) noexcept(
+        atraits_t::propagate_on_container_move_assignment::value || atraits_t::is_always_equal::value)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_move_assignment::value)
+        {
+            take_storage(other);
+            alloc_ = ::std::move(other.alloc_);
+        }
+        else
+        {
+            // Allocators that do not propagate, such as polymorphic_allocator,
+            // can still hand over the blocks when they share a resource.
+            if (alloc_ == other.alloc_)
+            {
+                take_storage(other);
+            }
+            else
+            {
+                other.finish_migration();
+                clear();
+                step_ = other.step_;
+                auto first = ::std::make_move_iterator(other.data_);
+                auto last = ::std::make_move_iterator(other.data_ + other.size_);
+                if (cap_ < other.size_)
+                {
+                    vector_detail::raw_memory raw(alloc_, other.size_);
+                    vector_detail::uninitialized_copy(alloc_, first, last, raw.get());
+                    replace_buffer(raw.release(), other.size_);
+                }
+                else
+                {
+                    vector_detail::uninitialized_copy(alloc_, first, last, data_);
+                }
+
+                size_ = other.size_;
+            }
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos)
+    {
+        return *locate(pos);
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const
+    {
+        return *locate(pos);
+    }
+
+    [[nodiscard]] reference front() noexcept
+    {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept
+    {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] reference back() noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] const_reference back() const noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    // Finishes any pending migration and returns the contiguous buffer.
+    [[nodiscard]] pointer data()
+    {
+        finish_migration();
+        return data_;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr size_type max_size() const noexcept
+    {
+        return ::std::numeric_limits<::std::size_t>::max() / sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    [[nodiscard]] constexpr bool migrating() const noexcept
+    {
+        return old_ != nullptr;
+    }
+
+    [[nodiscard]] constexpr size_type migration_step() const noexcept
+    {
+        return step_;
+    }
+
+    void set_migration_step(size_type step) noexcept
+    {
+        step_ = step < 2 ? 2 : step;
+    }
+
+    void finish_migration()
+    {
+        if (migrating())
+        {
+            migrate(old_size_ - migrated_);
+        }
+    }
+
+    void reserve(size_type required_cap)
+    {
+        if (required_cap <= cap_) [[unlikely]]
+        {
+            return;
+        }
+
+        finish_migration();
+
+        vector_detail::raw_memory raw(alloc_, required_cap);
+        vector_detail::uninitialized_relocate(alloc_, data_, data_ + size_, raw.get());
+        if constexpr (!is_trivially_relocatable_v<value_type>)
+        {
+            vector_detail::destroy_range(alloc_, data_, data_ + size_);
+        }
+
+        if (data_) [[likely]]
+        {
+            alloc_.deallocate(data_, cap_);
+        }
+
+        data_ = raw.release();
+        cap_ = required_cap;
+    }
+
+    void clear() noexcept
+    {
+        if (migrating())
+        {
+            vector_detail::destroy_range(alloc_, data_, data_ + migrated_);
+            vector_detail::destroy_range(alloc_, old_ + migrated_, old_ + old_size_);
+            vector_detail::destroy_range(alloc_, data_ + old_size_, data_ + size_);
+            release_old();
+        }
+        else
+        {
+            vector_detail::destroy_range(alloc_, data_, data_ + size_);
+        }
+
+        size_ = 0;
+    }
+
+    void push_back(const T &value)
+    {
+        (void)emplace_back_impl(value);
+    }
+
+    void push_back(T &&value)
+    {
+        (void)emplace_back_impl(::std::move(value));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args &&...args)
+    {
+        return *emplace_back_impl(::std::forward<Args>(args)...);
+    }
+
+    void pop_back()
+    {
+        check_bounds(!empty());
+
+        vector_detail::destroy_at(alloc_, locate(size_ - 1));
+        --size_;
+
+        if (migrating() && size_ < old_size_)
+        {
+            old_size_ = size_;
+            if (migrated_ >= old_size_)
+            {
+                release_old();
+                return;
+            }
+        }
+
+        if (migrating())
+        {
+            migrate(step_);
+        }
+    }
+
+    void swap(incremental_vector &other) noexcept
+    {
+        using ::std::swap;
+
+        swap(data_, other.data_);
+        swap(size_, other.size_);
+        swap(cap_, other.cap_);
+        swap(old_, other.old_);
+        swap(old_size_, other.old_size_);
+        swap(old_cap_, other.old_cap_);
+        swap(migrated_, other.migrated_);
+        swap(step_, other.step_);
+
+        if constexpr (atraits_t::propagate_on_container_swap::value)
+        {
+            swap(alloc_, other.alloc_);
+        }
+    }
+
+private:
+    // Copy-constructs the elements of other, in order, into out.
+    void uninitialized_copy_from(const incremental_vector &other, pointer out)
+    {
+        if (other.migrating())
+        {
+            vector_detail::uninitialized_copy(alloc_, other.data_, other.data_ + other.migrated_, out);
+            vector_detail::construction_guard guard(alloc_, out);
+            out += other.migrated_;
+            vector_detail::uninitialized_copy(alloc_, other.old_ + other.migrated_, other.old_ + other.old_size_, out);
+            out += other.old_size_ - other.migrated_;
+            vector_detail::uninitialized_copy(alloc_, other.data_ + other.old_size_, other.data_ + other.size_, out);
+            guard.release();
+        }
+        else
+        {
+            vector_detail::uninitialized_copy(alloc_, other.data_, other.data_ + other.size_, out);
+        }
+    }
+
+    // Frees the current buffer, which must hold no elements, and adopts p with
+    // room for new_cap elements.
+    void replace_buffer(pointer p, size_type new_cap) noexcept
+    {
+        if (data_) [[likely]]
+        {
+            alloc_.deallocate(data_, cap_);
+        }
+
+        data_ = p;
+        cap_ = new_cap;
+    }
+
+    void take_storage(incremental_vector &other) noexcept
+    {
+        destroy_and_deallocate();
+        data_ = ::std::exchange(other.data_, nullptr);
+        size_ = ::std::exchange(other.size_, 0);
+        cap_ = ::std::exchange(other.cap_, 0);
+        old_ = ::std::exchange(other.old_, nullptr);
+        old_size_ = ::std::exchange(other.old_size_, 0);
+        old_cap_ = ::std::exchange(other.old_cap_, 0);
+        migrated_ = ::std::exchange(other.migrated_, 0);
+        step_ = other.step_;
+    }
+
+    // [0, migrated_) and [old_size_, size_) live in the new block, the pending
+    // [migrated_, old_size_) still lives in the old one.
+    [[nodiscard]] pointer locate(size_type pos) const noexcept
+    {
+        if (pos - migrated_ < old_size_ - migrated_)
+        {
+            return old_ + pos;
+        }
+
+        return data_ + pos;
+    }
+
+    // Moves up to count pending elements from the old block into the new one
+    // and frees the old block once it is empty.
+    void migrate(size_type count)
+    {
+        auto pending = old_size_ - migrated_;
+        auto last = migrated_ + (count < pending ? count : pending);
+
+        vector_detail::uninitialized_relocate(alloc_, old_ + migrated_, old_ + last, data_ + migrated_);
+        if constexpr (!is_trivially_relocatable_v<value_type>)
+        {
+            vector_detail::destroy_range(alloc_, old_ + migrated_, old_ + last);
+        }
+
+        migrated_ = last;
+
+        if (migrated_ == old_size_)
+        {
+            release_old();
+        }
+    }
+
+    void release_old() noexcept
+    {
+        alloc_.deallocate(old_, old_cap_);
+        old_ = nullptr;
+        old_size_ = 0;
+        old_cap_ = 0;
+        migrated_ = 0;
+    }
+
+    template <typename... Args>
+    pointer emplace_back_impl(Args &&...args)
+    {
+        if (cap_ < size_ + 1)
+        {
+            finish_migration();
+
+            auto new_cap = static_cast<size_type>(GrowthPolicy::template next_capacity<value_type>(cap_, size_ + 1));
+            vector_detail::raw_memory raw(alloc_, new_cap);
+            vector_detail::construct_at(alloc_, raw.get() + size_, ::std::forward<Args>(args)...);
+
+            if (data_) [[likely]]
+            {
+                old_ = data_;
+                old_size_ = size_;
+                old_cap_ = cap_;
+                migrated_ = 0;
+            }
+
+            data_ = raw.release();
+            cap_ = new_cap;
+            ++size_;
+
+            if (migrating() && old_size_ == 0)
+            {
+                release_old();
+            }
+        }
+        else
+        {
+            vector_detail::construct_at(alloc_, data_ + size_, ::std::forward<Args>(args)...);
+            ++size_;
+        }
+
+        if (migrating())
+        {
+            migrate(step_);
+        }
+
+        return data_ + size_ - 1;
+    }
+
+    void destroy_and_deallocate() noexcept
+    {
+        clear();
+        if (data_) [[likely]]
+        {
+            alloc_.deallocate(data_, cap_);
+        }
+    }
+
+    pointer data_{};
+
+    size_type size_{};
+
+    size_type cap_{};
+
+    pointer old_{};
+
+    size_type old_size_{};
+
+    size_type old_cap_{};
+
+    size_type migrated_{};
+
+    size_type step_{};
+
+    [[no_unique_address]] Alloc alloc_{};
+};
+
+template <typename T, typename Alloc, typename GrowthPolicy>
+void swap(incremental_vector<T, Alloc, GrowthPolicy> &lhs,
+          incremental_vector<T, Alloc, GrowthPolicy> &rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
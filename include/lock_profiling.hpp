@@ -0,0 +1,262 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef EVQOVV_UTILS_LOCK_PROFILING
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#endif
+
+namespace evqovv
+{
+namespace utils
+{
+// Number of buckets of lock_stats::hold_histogram.
+inline constexpr ::std::size_t lock_hold_buckets = 32;
+
+// Contention statistics of the locks sharing a name, collected when
+// EVQOVV_UTILS_LOCK_PROFILING is defined. Only locks constructed with a name
+// are profiled. hold_histogram[i] counts critical sections that lasted less
+// than 2^i nanoseconds but not less than 2^(i - 1); the last bucket also
+// takes everything longer.
+struct lock_stats
+{
+    const char *name;
+    ::std::size_t acquisitions;
+    ::std::size_t contended;
+    ::std::uint64_t total_wait_ns;
+    ::std::uint64_t max_wait_ns;
+    ::std::size_t hold_histogram[lock_hold_buckets];
+};
+
+namespace lock_profiling_detail
+{
+#ifdef EVQOVV_UTILS_LOCK_PROFILING
+[[nodiscard]] inline ::std::uint64_t now_ns() noexcept
+{
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<::std::uint64_t>(ts.tv_sec) * 1000000000 + static_cast<::std::uint64_t>(ts.tv_nsec);
+}
+
+struct lock_record
+{
+    const char *name;
+    ::std::atomic<::std::size_t> acquisitions{0};
+    ::std::atomic<::std::size_t> contended{0};
+    ::std::atomic<::std::uint64_t> total_wait_ns{0};
+    ::std::atomic<::std::uint64_t> max_wait_ns{0};
+    ::std::atomic<::std::size_t> hold_histogram[lock_hold_buckets]{};
+    lock_record *next{};
+};
+
+// Records are never removed, so the registry is a lock-free list: it cannot
+// take a lock itself, as that lock would be profiled too. Never destroyed, so
+// locks with static storage duration can report during static destruction.
+inline ::std::atomic<lock_record *> registry_head{nullptr};
+
+[[nodiscard]] inline lock_record *find_or_add(const char *name)
+{
+    lock_record *added = nullptr;
+    auto head = registry_head.load(::std::memory_order_acquire);
+    for (;;)
+    {
+        for (auto r = head; r; r = r->next)
+        {
+            if (::std::strcmp(r->name, name) == 0)
+            {
+                delete added;
+                return r;
+            }
+        }
+
+        if (!added)
+        {
+            added = new lock_record;
+            added->name = name;
+        }
+
+        added->next = head;
+        if (registry_head.compare_exchange_weak(head, added, ::std::memory_order_acq_rel,
+                                                ::std::memory_order_acquire))
+        {
+            return added;
+        }
+    }
+}
+
+// Embedded in every lock type. Points at the record of the lock's name, or is
+// null for unnamed locks, which are not profiled.
+class lock_probe
+{
+public:
+    constexpr lock_probe() noexcept = default;
+
+    explicit lock_probe(const char *name) : record_(name ? find_or_add(name) : nullptr)
+    {
+    }
+
+    // Acquires the lock with lock_fn, first trying try_fn to tell whether the
+    // acquisition is contended and timing the wait if it is.
+    template <typename TryLock, typename Lock>
+    void acquire(TryLock try_fn, Lock lock_fn)
+    {
+        if (!record_)
+        {
+            lock_fn();
+            return;
+        }
+
+        if (!try_fn())
+        {
+            auto start = now_ns();
+            lock_fn();
+            auto wait = now_ns() - start;
+            record_->contended.fetch_add(1, ::std::memory_order_relaxed);
+            record_->total_wait_ns.fetch_add(wait, ::std::memory_order_relaxed);
+            auto max = record_->max_wait_ns.load(::std::memory_order_relaxed);
+            while (max < wait &&
+                   !record_->max_wait_ns.compare_exchange_weak(max, wait, ::std::memory_order_relaxed))
+            {
+            }
+        }
+
+        acquired();
+    }
+
+    template <typename TryLock>
+    [[nodiscard]] bool try_acquire(TryLock try_fn)
+    {
+        if (!try_fn())
+        {
+            return false;
+        }
+
+        if (record_)
+        {
+            acquired();
+        }
+
+        return true;
+    }
+
+    // Called before the lock is released.
+    void release() noexcept
+    {
+        if (record_)
+        {
+            auto hold = now_ns() - acquired_at_;
+            auto bucket = static_cast<::std::size_t>(::std::bit_width(hold));
+            if (bucket >= lock_hold_buckets)
+            {
+                bucket = lock_hold_buckets - 1;
+            }
+
+            record_->hold_histogram[bucket].fetch_add(1, ::std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void acquired() noexcept
+    {
+        record_->acquisitions.fetch_add(1, ::std::memory_order_relaxed);
+        acquired_at_ = now_ns();
+    }
+
+    lock_record *record_{};
+
+    // Written by the holder only.
+    ::std::uint64_t acquired_at_{};
+};
+#else
+// Stand-in for lock_probe when profiling is disabled; being empty and
+// [[no_unique_address]], it adds neither space nor code to the locks.
+struct lock_probe
+{
+    constexpr lock_probe() noexcept = default;
+
+    constexpr explicit lock_probe(const char *) noexcept
+    {
+    }
+
+    template <typename TryLock, typename Lock>
+    void acquire(TryLock, Lock lock_fn)
+    {
+        lock_fn();
+    }
+
+    template <typename TryLock>
+    [[nodiscard]] bool try_acquire(TryLock try_fn)
+    {
+        return try_fn();
+    }
+
+    constexpr void release() const noexcept
+    {
+    }
+};
+#endif
+} // namespace lock_profiling_detail
+
+// Calls f(const lock_stats &) for every lock name. Does nothing when
+// profiling is disabled.
+template <typename F>
+void for_each_lock_profile(F &&f)
+{
+#ifdef EVQOVV_UTILS_LOCK_PROFILING
+    for (auto r = lock_profiling_detail::registry_head.load(::std::memory_order_acquire); r; r = r->next)
+    {
+        lock_stats s{r->name,
+                     r->acquisitions.load(::std::memory_order_relaxed),
+                     r->contended.load(::std::memory_order_relaxed),
+                     r->total_wait_ns.load(::std::memory_order_relaxed),
+                     r->max_wait_ns.load(::std::memory_order_relaxed),
+                     {}};
+        for (::std::size_t i = 0; i != lock_hold_buckets; ++i)
+        {
+            s.hold_histogram[i] = r->hold_histogram[i].load(::std::memory_order_relaxed);
+        }
+
+        f(static_cast<const lock_stats &>(s));
+    }
+#else
+    (void)f;
+#endif
+}
+
+// Prints one line per lock name, followed by the non-empty buckets of its
+// hold-time histogram as <2^i ns:count.
+inline void dump_lock_profile(::std::FILE *out = stderr)
+{
+    for_each_lock_profile([out](const lock_stats &s) {
+        ::std::fprintf(out, "%s: acquisitions=%zu contended=%zu total_wait_ns=%llu max_wait_ns=%llu hold_ns:", s.name,
+                       s.acquisitions, s.contended, static_cast<unsigned long long>(s.total_wait_ns),
+                       static_cast<unsigned long long>(s.max_wait_ns));
+        for (::std::size_t i = 0; i != lock_hold_buckets; ++i)
+        {
+            if (s.hold_histogram[i] != 0)
+            {
+                ::std::fprintf(out, " <2^%zu:%zu", i, s.hold_histogram[i]);
+            }
+        }
+
+        ::std::fputc('\n', out);
+    });
+}
+
+// Arranges for dump_lock_profile(stderr) to run at exit. Does nothing when
+// profiling is disabled.
+inline void dump_lock_profile_at_exit()
+{
+#ifdef EVQOVV_UTILS_LOCK_PROFILING
+    static bool registered = [] { return ::std::atexit([] { dump_lock_profile(stderr); }) == 0; }();
+    (void)registered;
+#endif
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,486 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "vector.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace evqovv
+{
+namespace utils
+{
+enum class map_mode
+{
+    read_only,
+    read_write,
+};
+
+enum class access_advice
+{
+    normal,
+    sequential,
+    random,
+    will_need,
+};
+
+// A vector of trivially copyable elements that lives in a memory-mapped file,
+// so a table written once can be opened again without deserializing it. The
+// file starts with a header (magic, element size, size, capacity) followed by
+// the elements at a 64-byte aligned offset.
+//
+// read_only maps an existing file without copying anything. The mapping is
+// private, so elements may be modified through it, but the changes stay in
+// this process (the touched pages are copied on write) and never reach the
+// file; the size cannot change. read_write
+// creates the file if needed and grows it with ftruncate and mremap. Changes
+// reach the file when the kernel writes the pages back, or immediately after
+// sync().
+template <typename T, typename GrowthPolicy = default_growth>
+class mapped_vector
+{
+    static_assert(::std::is_trivially_copyable_v<T>, "mapped_vector requires a trivially copyable T.");
+
+    struct header
+    {
+        ::std::uint64_t magic;
+        ::std::uint64_t element_size;
+        ::std::uint64_t size;
+        ::std::uint64_t capacity;
+    };
+
+    static constexpr ::std::size_t data_offset = 64;
+
+    static_assert(sizeof(header) <= data_offset && alignof(T) <= data_offset);
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+
+    static constexpr ::std::uint64_t file_magic = 0x31564D5651564545; // "EEVQVMV1"
+
+    explicit mapped_vector(const char *path, map_mode mode = map_mode::read_only)
+        : writable_(mode == map_mode::read_write)
+    {
+        fd_ = ::open(path, writable_ ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd_ == -1) [[unlikely]]
+        {
+            throw_system_exception("open failed: ");
+        }
+
+        file_guard guard(*this);
+
+        struct ::stat st;
+        if (::fstat(fd_, &st) != 0) [[unlikely]]
+        {
+            throw_system_exception("fstat failed: ");
+        }
+
+        auto file_size = static_cast<size_type>(st.st_size);
+        if (file_size == 0 && writable_)
+        {
+            file_size = allocator_detail::page_size();
+            resize_file(file_size);
+            map(file_size);
+            *get_header() = header{file_magic, sizeof(T), 0, capacity_for(file_size)};
+        }
+        else
+        {
+            if (file_size < data_offset) [[unlikely]]
+            {
+                throw_system_exception(EINVAL, "mapped_vector: file too small: ");
+            }
+
+            map(file_size);
+            validate(file_size);
+        }
+
+        guard.release();
+    }
+
+    mapped_vector(const mapped_vector &) = delete;
+    mapped_vector &operator=(const mapped_vector &) = delete;
+
+    mapped_vector(mapped_vector &&other) noexcept
+        : fd_(::std::exchange(other.fd_, -1)), map_(::std::exchange(other.map_, nullptr)),
+          map_size_(::std::exchange(other.map_size_, 0)), writable_(::std::exchange(other.writable_, false))
+    {
+    }
+
+    mapped_vector &operator=(mapped_vector &&other) noexcept
+    {
+        if (::std::addressof(other) != this) [[likely]]
+        {
+            mapped_vector tmp(::std::move(other));
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    ~mapped_vector()
+    {
+        close();
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        check_bounds(pos < size());
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        check_bounds(pos < size());
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos) noexcept
+    {
+        return data()[pos];
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const noexcept
+    {
+        return data()[pos];
+    }
+
+    // Null for a moved-from mapped_vector, which also reports size and capacity
+    // 0.
+    [[nodiscard]] pointer data() noexcept
+    {
+        if (!map_) [[unlikely]]
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<pointer>(static_cast<unsigned char *>(map_) + data_offset);
+    }
+
+    [[nodiscard]] const_pointer data() const noexcept
+    {
+        if (!map_) [[unlikely]]
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<const_pointer>(static_cast<const unsigned char *>(map_) + data_offset);
+    }
+
+    [[nodiscard]] iterator begin() noexcept
+    {
+        return data();
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    [[nodiscard]] iterator end() noexcept
+    {
+        return data() + size();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return data() + size();
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        if (!map_) [[unlikely]]
+        {
+            return 0;
+        }
+
+        return static_cast<size_type>(get_header()->size);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        if (!map_) [[unlikely]]
+        {
+            return 0;
+        }
+
+        return static_cast<size_type>(get_header()->capacity);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] bool writable() const noexcept
+    {
+        return writable_;
+    }
+
+    void reserve(size_type required_cap)
+    {
+        check_writable();
+
+        if (required_cap <= capacity()) [[unlikely]]
+        {
+            return;
+        }
+
+        grow_file(required_cap);
+    }
+
+    void push_back(const T &value)
+    {
+        append(::std::addressof(value), 1);
+    }
+
+    // Appends count elements copied from first.
+    void append(const T *first, size_type count)
+    {
+        check_writable();
+
+        auto n = size();
+        if (capacity() - n < count)
+        {
+            // first may point into the mapping, which grow_file can move.
+            bool inside = !::std::less<>()(first, data()) && ::std::less<>()(first, data() + n);
+            difference_type offset = inside ? first - data() : 0;
+            grow_file(GrowthPolicy::template next_capacity<T>(capacity(), n + count));
+            if (inside)
+            {
+                first = data() + offset;
+            }
+        }
+
+        ::std::memmove(data() + n, first, count * sizeof(T));
+        get_header()->size = n + count;
+    }
+
+    void pop_back()
+    {
+        check_writable();
+
+        check_bounds(!empty());
+
+        --get_header()->size;
+    }
+
+    void clear()
+    {
+        check_writable();
+        get_header()->size = 0;
+    }
+
+    // Writes dirty pages back to the file; with async the call only schedules
+    // the write-back.
+    void sync(bool async = false)
+    {
+        if (!map_) [[unlikely]]
+        {
+            return;
+        }
+
+        if (::msync(map_, map_size_, async ? MS_ASYNC : MS_SYNC) != 0) [[unlikely]]
+        {
+            throw_system_exception("msync failed: ");
+        }
+    }
+
+    // Tells the kernel how the elements are about to be accessed, e.g.
+    // sequential to read ahead aggressively during a full scan.
+    void advise(access_advice advice)
+    {
+        if (!map_) [[unlikely]]
+        {
+            return;
+        }
+
+        int native = MADV_NORMAL;
+        switch (advice)
+        {
+        case access_advice::sequential:
+            native = MADV_SEQUENTIAL;
+            break;
+        case access_advice::random:
+            native = MADV_RANDOM;
+            break;
+        case access_advice::will_need:
+            native = MADV_WILLNEED;
+            break;
+        default:
+            break;
+        }
+
+        if (::madvise(map_, map_size_, native) != 0) [[unlikely]]
+        {
+            throw_system_exception("madvise failed: ");
+        }
+    }
+
+    void swap(mapped_vector &other) noexcept
+    {
+        using ::std::swap;
+
+        swap(fd_, other.fd_);
+        swap(map_, other.map_);
+        swap(map_size_, other.map_size_);
+        swap(writable_, other.writable_);
+    }
+
+private:
+    // Unmaps and closes the file if the constructor throws.
+    class file_guard
+    {
+        mapped_vector &v_;
+        bool flag_ = true;
+
+    public:
+        explicit file_guard(mapped_vector &v) noexcept : v_(v)
+        {
+        }
+
+        ~file_guard()
+        {
+            if (flag_) [[unlikely]]
+            {
+                v_.close();
+            }
+        }
+
+        void release() noexcept
+        {
+            flag_ = false;
+        }
+    };
+
+    [[nodiscard]] header *get_header() noexcept
+    {
+        return static_cast<header *>(map_);
+    }
+
+    [[nodiscard]] const header *get_header() const noexcept
+    {
+        return static_cast<const header *>(map_);
+    }
+
+    [[nodiscard]] static constexpr size_type capacity_for(size_type file_size) noexcept
+    {
+        return (file_size - data_offset) / sizeof(T);
+    }
+
+    void check_writable() const noexcept
+    {
+        if (!writable_) [[unlikely]]
+        {
+            terminate();
+        }
+    }
+
+    void validate(size_type file_size) const
+    {
+        auto h = get_header();
+        if (h->magic != file_magic || h->element_size != sizeof(T)) [[unlikely]]
+        {
+            throw_system_exception(EINVAL, "mapped_vector: header mismatch: ");
+        }
+
+        if (h->size > h->capacity || h->capacity > capacity_for(file_size)) [[unlikely]]
+        {
+            throw_system_exception(EINVAL, "mapped_vector: corrupt header: ");
+        }
+    }
+
+    void map(size_type length)
+    {
+        auto p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, writable_ ? MAP_SHARED : MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) [[unlikely]]
+        {
+            throw_system_exception("mmap failed: ");
+        }
+
+        map_ = p;
+        map_size_ = length;
+    }
+
+    void resize_file(size_type length)
+    {
+        if (::ftruncate(fd_, static_cast<::off_t>(length)) != 0) [[unlikely]]
+        {
+            throw_system_exception("ftruncate failed: ");
+        }
+    }
+
+    // Extends the file to hold at least required_cap elements, rounded up to
+    // whole pages, and remaps it.
+    void grow_file(size_type required_cap)
+    {
+        if (required_cap > (::std::numeric_limits<size_type>::max() - data_offset) / sizeof(T)) [[unlikely]]
+        {
+            throw ::std::bad_array_new_length();
+        }
+
+        auto page = allocator_detail::page_size();
+        auto length = (data_offset + required_cap * sizeof(T) + page - 1) / page * page;
+
+        resize_file(length);
+
+        auto p = ::mremap(map_, map_size_, length, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) [[unlikely]]
+        {
+            throw_system_exception("mremap failed: ");
+        }
+
+        map_ = p;
+        map_size_ = length;
+        get_header()->capacity = capacity_for(length);
+    }
+
+    void close() noexcept
+    {
+        if (map_)
+        {
+            if (::munmap(map_, map_size_) != 0) [[unlikely]]
+            {
+                terminate();
+            }
+
+            map_ = nullptr;
+        }
+
+        if (fd_ != -1)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_ = -1;
+
+    void *map_{};
+
+    size_type map_size_{};
+
+    bool writable_{};
+};
+
+template <typename T, typename GrowthPolicy>
+void swap(mapped_vector<T, GrowthPolicy> &lhs, mapped_vector<T, GrowthPolicy> &rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,435 @@
+#pragma once
+
+#include "arena.hpp"
+#include "helper.hpp"
+#include "mutex.hpp"
+#include "thread_cache.hpp"
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace evqovv
+{
+namespace utils
+{
+// Abstract source of memory. Containers reach it through
+// polymorphic_allocator, so the memory strategy can be chosen at run time
+// without changing the container type.
+class memory_resource
+{
+public:
+    static constexpr ::std::size_t max_align = alignof(::std::max_align_t);
+
+    virtual ~memory_resource() = default;
+
+    [[nodiscard]] void *allocate(::std::size_t bytes, ::std::size_t align = max_align)
+    {
+        return do_allocate(bytes, align);
+    }
+
+    void deallocate(void *p, ::std::size_t bytes, ::std::size_t align = max_align) noexcept
+    {
+        do_deallocate(p, bytes, align);
+    }
+
+    // Two resources are equal when memory allocated from one can be freed
+    // through the other.
+    [[nodiscard]] bool is_equal(const memory_resource &other) const noexcept
+    {
+        return this == ::std::addressof(other) || do_is_equal(other);
+    }
+
+private:
+    virtual void *do_allocate(::std::size_t bytes, ::std::size_t align) = 0;
+
+    virtual void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t align) noexcept = 0;
+
+    virtual bool do_is_equal(const memory_resource &other) const noexcept
+    {
+        return this == ::std::addressof(other);
+    }
+};
+
+inline bool operator==(const memory_resource &lhs, const memory_resource &rhs) noexcept
+{
+    return lhs.is_equal(rhs);
+}
+
+namespace memory_resource_detail
+{
+class new_delete_resource_impl final : public memory_resource
+{
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override
+    {
+        return ::operator new(bytes, ::std::align_val_t(align));
+    }
+
+    void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t align) noexcept override
+    {
+        ::operator delete(p, bytes, ::std::align_val_t(align));
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+        return dynamic_cast<const new_delete_resource_impl *>(::std::addressof(other)) != nullptr;
+    }
+};
+} // namespace memory_resource_detail
+
+// A resource forwarding to the global operator new and delete.
+[[nodiscard]] inline memory_resource *new_delete_resource() noexcept
+{
+    static memory_resource_detail::new_delete_resource_impl resource;
+    return &resource;
+}
+
+namespace memory_resource_detail
+{
+[[nodiscard]] inline ::std::atomic<memory_resource *> &default_resource() noexcept
+{
+    static ::std::atomic<memory_resource *> resource{new_delete_resource()};
+    return resource;
+}
+} // namespace memory_resource_detail
+
+[[nodiscard]] inline memory_resource *get_default_resource() noexcept
+{
+    return memory_resource_detail::default_resource().load(::std::memory_order_acquire);
+}
+
+// Replaces the resource used by default-constructed polymorphic_allocators
+// and returns the previous one; nullptr restores new_delete_resource().
+inline memory_resource *set_default_resource(memory_resource *r) noexcept
+{
+    return memory_resource_detail::default_resource().exchange(r ? r : new_delete_resource(),
+                                                               ::std::memory_order_acq_rel);
+}
+
+// Allocator delegating to a memory_resource. It never propagates on copy,
+// move or swap, so a container keeps its resource for life; vector still
+// moves buffers between containers whose resources compare equal.
+template <typename T>
+class polymorphic_allocator
+{
+    template <typename U>
+    friend class polymorphic_allocator;
+
+public:
+    using value_type = T;
+
+    polymorphic_allocator() noexcept : resource_(get_default_resource())
+    {
+    }
+
+    polymorphic_allocator(memory_resource *r) noexcept : resource_(r)
+    {
+    }
+
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept : resource_(other.resource_)
+    {
+    }
+
+    polymorphic_allocator &operator=(const polymorphic_allocator &) = delete;
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        if (n > ::std::numeric_limits<::std::size_t>::max() / sizeof(T)) [[unlikely]]
+        {
+            throw ::std::bad_array_new_length();
+        }
+
+        return static_cast<T *>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // Copies of a container get the default resource, not the source's.
+    [[nodiscard]] polymorphic_allocator select_on_container_copy_construction() const noexcept
+    {
+        return polymorphic_allocator();
+    }
+
+    [[nodiscard]] memory_resource *resource() const noexcept
+    {
+        return resource_;
+    }
+
+    template <typename U>
+    friend bool operator==(const polymorphic_allocator &lhs, const polymorphic_allocator<U> &rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+private:
+    memory_resource *resource_;
+};
+
+// Bump allocation on top of an arena: deallocation is a no-op and release()
+// frees everything at once.
+class monotonic_buffer_resource : public memory_resource
+{
+public:
+    explicit monotonic_buffer_resource(::std::size_t block_size = arena::default_block_size) noexcept
+        : arena_(block_size)
+    {
+    }
+
+    monotonic_buffer_resource(void *buffer, ::std::size_t size,
+                              ::std::size_t block_size = arena::default_block_size) noexcept
+        : arena_(buffer, size, block_size)
+    {
+    }
+
+    void release() noexcept
+    {
+        arena_.release();
+    }
+
+private:
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override
+    {
+        return arena_.allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t) noexcept override
+    {
+        arena_.deallocate(p, bytes);
+    }
+
+    arena arena_;
+};
+
+// Pools of fixed-size blocks in the size classes of the thread caches, carved
+// from chunks obtained from an upstream resource. Blocks above the largest
+// class or with extended alignment go straight to upstream. Not thread-safe.
+class unsynchronized_pool_resource : public memory_resource
+{
+    struct node
+    {
+        node *next;
+    };
+
+    struct chunk
+    {
+        chunk *next;
+        ::std::size_t bytes;
+    };
+
+    static constexpr ::std::size_t chunk_header = 16;
+    static constexpr ::std::size_t blocks_per_chunk = 64;
+
+public:
+    explicit unsynchronized_pool_resource(memory_resource *upstream = get_default_resource()) noexcept
+        : upstream_(upstream)
+    {
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource &) = delete;
+    unsynchronized_pool_resource &operator=(const unsynchronized_pool_resource &) = delete;
+
+    ~unsynchronized_pool_resource() override
+    {
+        release();
+    }
+
+    // Returns every chunk to upstream, including blocks still in use.
+    void release() noexcept
+    {
+        for (auto c = chunks_; c;)
+        {
+            auto next = c->next;
+            upstream_->deallocate(c, c->bytes);
+            c = next;
+        }
+
+        chunks_ = nullptr;
+        for (auto &head : free_)
+        {
+            head = nullptr;
+        }
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+private:
+    [[nodiscard]] static bool is_pooled(::std::size_t bytes, ::std::size_t align) noexcept
+    {
+        return bytes <= thread_cache_detail::max_size && align <= thread_cache_detail::max_alignment;
+    }
+
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override
+    {
+        if (!is_pooled(bytes, align)) [[unlikely]]
+        {
+            return upstream_->allocate(bytes, align);
+        }
+
+        auto c = thread_cache_detail::class_index(bytes);
+        if (!free_[c]) [[unlikely]]
+        {
+            add_chunk(c);
+        }
+
+        auto n = free_[c];
+        free_[c] = n->next;
+        return n;
+    }
+
+    void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t align) noexcept override
+    {
+        if (!is_pooled(bytes, align)) [[unlikely]]
+        {
+            upstream_->deallocate(p, bytes, align);
+            return;
+        }
+
+        auto c = thread_cache_detail::class_index(bytes);
+        auto n = static_cast<node *>(p);
+        n->next = free_[c];
+        free_[c] = n;
+    }
+
+    void add_chunk(::std::size_t c)
+    {
+        auto size = thread_cache_detail::class_size(c);
+        auto count = size < 4096 ? blocks_per_chunk : 4;
+        auto bytes = chunk_header + size * count;
+        auto raw = static_cast<unsigned char *>(upstream_->allocate(bytes));
+
+        auto ch = reinterpret_cast<chunk *>(raw);
+        ch->next = chunks_;
+        ch->bytes = bytes;
+        chunks_ = ch;
+
+        auto first = raw + chunk_header;
+        for (::std::size_t i = count; i != 0; --i)
+        {
+            auto n = reinterpret_cast<node *>(first + (i - 1) * size);
+            n->next = free_[c];
+            free_[c] = n;
+        }
+    }
+
+    memory_resource *upstream_;
+
+    chunk *chunks_{};
+
+    node *free_[thread_cache_detail::class_count]{};
+};
+
+// unsynchronized_pool_resource behind a utils::mutex, for sharing one pool
+// between threads.
+class synchronized_pool_resource : public memory_resource
+{
+public:
+    explicit synchronized_pool_resource(memory_resource *upstream = get_default_resource()) noexcept
+        : pool_(upstream)
+    {
+    }
+
+    void release()
+    {
+        ::std::lock_guard<mutex> guard(lock_);
+        pool_.release();
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept
+    {
+        return pool_.upstream_resource();
+    }
+
+private:
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override
+    {
+        ::std::lock_guard<mutex> guard(lock_);
+        return pool_.allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t align) noexcept override
+    {
+        ::std::lock_guard<mutex> guard(lock_);
+        pool_.deallocate(p, bytes, align);
+    }
+
+    mutex lock_;
+
+    unsynchronized_pool_resource pool_;
+};
+
+struct memory_stats
+{
+    ::std::size_t allocations;
+    ::std::size_t deallocations;
+    ::std::size_t bytes_allocated;
+    ::std::size_t bytes_in_use;
+    ::std::size_t peak_bytes_in_use;
+};
+
+// Forwards to an upstream resource and counts what passes through. The
+// counters are atomic, so the wrapper is as thread-safe as its upstream.
+class stats_resource : public memory_resource
+{
+public:
+    explicit stats_resource(memory_resource *upstream = get_default_resource()) noexcept : upstream_(upstream)
+    {
+    }
+
+    [[nodiscard]] memory_stats stats() const noexcept
+    {
+        return {allocations_.load(::std::memory_order_relaxed), deallocations_.load(::std::memory_order_relaxed),
+                bytes_allocated_.load(::std::memory_order_relaxed), bytes_in_use_.load(::std::memory_order_relaxed),
+                peak_bytes_in_use_.load(::std::memory_order_relaxed)};
+    }
+
+    [[nodiscard]] memory_resource *upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+private:
+    void *do_allocate(::std::size_t bytes, ::std::size_t align) override
+    {
+        auto p = upstream_->allocate(bytes, align);
+
+        allocations_.fetch_add(1, ::std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(bytes, ::std::memory_order_relaxed);
+        auto in_use = bytes_in_use_.fetch_add(bytes, ::std::memory_order_relaxed) + bytes;
+        auto peak = peak_bytes_in_use_.load(::std::memory_order_relaxed);
+        while (peak < in_use && !peak_bytes_in_use_.compare_exchange_weak(peak, in_use, ::std::memory_order_relaxed))
+        {
+        }
+
+        return p;
+    }
+
+    void do_deallocate(void *p, ::std::size_t bytes, ::std::size_t align) noexcept override
+    {
+        upstream_->deallocate(p, bytes, align);
+        deallocations_.fetch_add(1, ::std::memory_order_relaxed);
+        bytes_in_use_.fetch_sub(bytes, ::std::memory_order_relaxed);
+    }
+
+    memory_resource *upstream_;
+
+    ::std::atomic<::std::size_t> allocations_{0};
+
+    ::std::atomic<::std::size_t> deallocations_{0};
+
+    ::std::atomic<::std::size_t> bytes_allocated_{0};
+
+    ::std::atomic<::std::size_t> bytes_in_use_{0};
+
+    ::std::atomic<::std::size_t> peak_bytes_in_use_{0};
+};
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "helper.hpp"
+#include "lock_profiling.hpp"
 #include <pthread.h>
 
 namespace evqovv
@@ -18,7 +19,13 @@ public:
     mutex(mutex &&) = delete;
     mutex &operator=(mutex &&) = delete;
 
-    mutex() noexcept
+    mutex() noexcept : mutex(nullptr)
+    {
+    }
+
+    // A named mutex is profiled under that name when
+    // EVQOVV_UTILS_LOCK_PROFILING is defined; the name must outlive it.
+    explicit mutex(const char *name) noexcept : probe_(name)
     {
         if (::pthread_mutex_init(&mutex_, nullptr) != 0) [[unlikely]]
         {
@@ -35,6 +42,31 @@ public:
     }
 
     void lock()
+    {
+        probe_.acquire([this] { return try_acquire(); }, [this] { acquire(); });
+    }
+
+    bool try_lock()
+    {
+        return probe_.try_acquire([this] { return try_acquire(); });
+    }
+
+    void unlock()
+    {
+        probe_.release();
+        if (::pthread_mutex_unlock(&mutex_) != 0)
+        {
+            throw_system_exception("pthread_mutex_unlock failed: ");
+        }
+    }
+
+    [[nodiscard]] native_handle_type native_handle() noexcept
+    {
+        return &mutex_;
+    }
+
+private:
+    void acquire()
     {
         if (::pthread_mutex_lock(&mutex_) != 0)
         {
@@ -42,7 +74,7 @@ public:
         }
     }
 
-    bool try_lock()
+    bool try_acquire()
     {
         auto ret = ::pthread_mutex_trylock(&mutex_);
         if (ret == 0)
@@ -59,21 +91,9 @@ public:
         }
     }
 
-    void unlock()
-    {
-        if (::pthread_mutex_unlock(&mutex_) != 0)
-        {
-            throw_system_exception("pthread_mutex_unlock failed: ");
-        }
-    }
-
-    [[nodiscard]] native_handle_type native_handle() noexcept
-    {
-        return &mutex_;
-    }
-
-private:
     ::pthread_mutex_t mutex_;
+
+    [[no_unique_address]] lock_profiling_detail::lock_probe probe_;
 };
 } // namespace utils
 } // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "helper.hpp"
+#include "unique_ptr.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace evqovv
+{
+namespace utils
+{
+template <typename Pool>
+struct pool_deleter;
+
+// A pool of same-sized slots for T. Slots come from slabs of SlabSize slots
+// that are carved lazily and never returned before the pool is destroyed;
+// freed slots go onto an intrusive free list, so acquiring and releasing an
+// object is a couple of pointer moves instead of a malloc round trip.
+//
+// The pool is not thread-safe, and every object must be released before the
+// pool is destroyed.
+template <typename T, ::std::size_t SlabSize = (sizeof(T) < 256 ? 16384 / (sizeof(T) < 16 ? 16 : sizeof(T)) : 64)>
+class object_pool
+{
+    static_assert(SlabSize != 0);
+
+    union slot {
+        slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct slab
+    {
+        slab *next;
+        slot slots[SlabSize];
+    };
+
+public:
+    using value_type = T;
+    using size_type = ::std::size_t;
+    using pointer = unique_ptr<T, pool_deleter<object_pool>>;
+
+    static constexpr size_type slab_size = SlabSize;
+
+    object_pool() noexcept = default;
+
+    object_pool(const object_pool &) = delete;
+    object_pool &operator=(const object_pool &) = delete;
+
+    object_pool(object_pool &&) = delete;
+    object_pool &operator=(object_pool &&) = delete;
+
+    ~object_pool()
+    {
+        for (auto s = slabs_; s;)
+        {
+            auto next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    // Returns uninitialized storage for one T.
+    [[nodiscard]] void *allocate()
+    {
+        if (free_) [[likely]]
+        {
+            auto s = free_;
+            free_ = s->next;
+            return s->storage;
+        }
+
+        if (carve_ == carve_end_) [[unlikely]]
+        {
+            add_slab();
+        }
+
+        return (carve_++)->storage;
+    }
+
+    void deallocate(void *p) noexcept
+    {
+        auto s = ::new (p) slot;
+        s->next = free_;
+        free_ = s;
+    }
+
+    template <typename... Args>
+    [[nodiscard]] T *create(Args &&...args)
+    {
+        auto p = allocate();
+        slot_guard guard(*this, p);
+        auto obj = ::new (p) T(::std::forward<Args>(args)...);
+        guard.release();
+        return obj;
+    }
+
+    void destroy(T *p) noexcept
+    {
+        p->~T();
+        deallocate(p);
+    }
+
+    // Creates an object whose unique_ptr returns the slot to this pool. The
+    // deleter stores the pool address; see static_pool_deleter for an empty
+    // one.
+    template <typename... Args>
+    [[nodiscard]] pointer acquire(Args &&...args)
+    {
+        return pointer(create(::std::forward<Args>(args)...), pool_deleter<object_pool>(*this));
+    }
+
+private:
+    // Returns the slot to the pool if the constructor throws.
+    class slot_guard
+    {
+        object_pool &pool_;
+        void *p_;
+        bool flag_ = true;
+
+    public:
+        slot_guard(object_pool &pool, void *p) noexcept : pool_(pool), p_(p)
+        {
+        }
+
+        ~slot_guard()
+        {
+            if (flag_) [[unlikely]]
+            {
+                pool_.deallocate(p_);
+            }
+        }
+
+        void release() noexcept
+        {
+            flag_ = false;
+        }
+    };
+
+    void add_slab()
+    {
+        auto s = new slab;
+        s->next = slabs_;
+        slabs_ = s;
+        carve_ = s->slots;
+        carve_end_ = s->slots + SlabSize;
+    }
+
+    slot *free_{};
+
+    slot *carve_{};
+
+    slot *carve_end_{};
+
+    slab *slabs_{};
+};
+
+// Returns objects to the pool they were acquired from.
+template <typename Pool>
+struct pool_deleter
+{
+    constexpr pool_deleter() noexcept = default;
+
+    explicit pool_deleter(Pool &pool) noexcept : pool_(::std::addressof(pool))
+    {
+    }
+
+    void operator()(typename Pool::value_type *p) noexcept
+    {
+        pool_->destroy(p);
+    }
+
+private:
+    Pool *pool_{};
+};
+
+// Deleter for a pool with static storage duration, named by reference. It is
+// empty, so unique_ptr<T, static_pool_deleter<Pool>> stays pointer-sized.
+template <auto &Pool>
+struct static_pool_deleter
+{
+    using pool_type = ::std::remove_reference_t<decltype(Pool)>;
+
+    void operator()(typename pool_type::value_type *p) noexcept
+    {
+        Pool.destroy(p);
+    }
+};
+
+template <auto &Pool>
+using static_pool_ptr =
+    unique_ptr<typename static_pool_deleter<Pool>::pool_type::value_type, static_pool_deleter<Pool>>;
+
+template <auto &Pool, typename... Args>
+[[nodiscard]] static_pool_ptr<Pool> acquire(Args &&...args)
+{
+    return static_pool_ptr<Pool>(Pool.create(::std::forward<Args>(args)...));
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
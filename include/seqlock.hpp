@@ -0,0 +1,142 @@
+#pragma once
+
+#include "helper.hpp"
+#include "mutex.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+namespace evqovv
+{
+namespace utils
+{
+// Holds a small trivially copyable value that many threads read and few
+// write. Readers take no lock and write nothing: they copy the value and
+// retry if a writer was active meanwhile, as told by a sequence number that
+// is odd during a write. Writers are serialized by Lock.
+//
+// The value is stored as relaxed atomic words so that a read racing a write
+// is not a data race; the fences around the copies order them against the
+// sequence number. Readers spin while a write is in progress, so keep writes
+// short.
+template <typename T, typename Lock = mutex>
+class seqlock
+{
+    static_assert(::std::is_trivially_copyable_v<T>, "seqlock requires a trivially copyable type");
+
+    using word = ::std::uintptr_t;
+
+    static constexpr ::std::size_t word_count = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+public:
+    using value_type = T;
+
+    seqlock(const seqlock &) = delete;
+    seqlock &operator=(const seqlock &) = delete;
+
+    seqlock(seqlock &&) = delete;
+    seqlock &operator=(seqlock &&) = delete;
+
+    seqlock() noexcept(::std::is_nothrow_default_constructible_v<Lock>) : seqlock(T{})
+    {
+    }
+
+    explicit seqlock(const T &value) noexcept(::std::is_nothrow_default_constructible_v<Lock>)
+    {
+        write_words(value);
+    }
+
+    // Passes name to the writers' Lock, e.g. to profile writer contention
+    // when EVQOVV_UTILS_LOCK_PROFILING is defined; readers take no lock.
+    seqlock(const char *name, const T &value) noexcept(::std::is_nothrow_constructible_v<Lock, const char *>)
+        : lock_(name)
+    {
+        write_words(value);
+    }
+
+    [[nodiscard]] T load() const noexcept
+    {
+        word buf[word_count];
+        for (;;)
+        {
+            auto seq = seq_.load(::std::memory_order_acquire);
+            if (seq & 1) [[unlikely]]
+            {
+                cpu_relax();
+                continue;
+            }
+
+            for (::std::size_t i = 0; i != word_count; ++i)
+            {
+                buf[i] = words_[i].load(::std::memory_order_relaxed);
+            }
+
+            ::std::atomic_thread_fence(::std::memory_order_acquire);
+            if (seq_.load(::std::memory_order_relaxed) == seq) [[likely]]
+            {
+                return to_value(buf);
+            }
+        }
+    }
+
+    void store(const T &value)
+    {
+        ::std::lock_guard<Lock> guard(lock_);
+        write(value);
+    }
+
+    // Replaces the value with f applied to it, atomically with respect to
+    // other writers.
+    template <typename F>
+    void update(F &&f)
+    {
+        ::std::lock_guard<Lock> guard(lock_);
+        word buf[word_count];
+        for (::std::size_t i = 0; i != word_count; ++i)
+        {
+            buf[i] = words_[i].load(::std::memory_order_relaxed);
+        }
+
+        auto value = to_value(buf);
+        ::std::forward<F>(f)(value);
+        write(value);
+    }
+
+private:
+    [[nodiscard]] static T to_value(const word *buf) noexcept
+    {
+        T value;
+        ::std::memcpy(static_cast<void *>(::std::addressof(value)), buf, sizeof(T));
+        return value;
+    }
+
+    void write_words(const T &value) noexcept
+    {
+        word buf[word_count]{};
+        ::std::memcpy(buf, static_cast<const void *>(::std::addressof(value)), sizeof(T));
+        for (::std::size_t i = 0; i != word_count; ++i)
+        {
+            words_[i].store(buf[i], ::std::memory_order_relaxed);
+        }
+    }
+
+    void write(const T &value) noexcept
+    {
+        auto seq = seq_.load(::std::memory_order_relaxed);
+        seq_.store(seq + 1, ::std::memory_order_relaxed);
+        ::std::atomic_thread_fence(::std::memory_order_release);
+        write_words(value);
+        seq_.store(seq + 2, ::std::memory_order_release);
+    }
+
+    ::std::atomic<::std::size_t> seq_{0};
+
+    ::std::atomic<word> words_[word_count]{};
+
+    Lock lock_;
+};
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
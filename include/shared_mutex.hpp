@@ -0,0 +1,199 @@
+#pragma once
+
+#include "futex_mutex.hpp"
+#include "lock_profiling.hpp"
+#include "spinlock.hpp"
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+namespace evqovv
+{
+namespace utils
+{
+namespace shared_mutex_detail
+{
+inline constexpr ::std::size_t shard_count = 32;
+
+inline ::std::atomic<::std::size_t> next_slot{0};
+
+// Threads are spread over the shards round-robin in the order they first
+// take a shared lock.
+[[nodiscard]] inline ::std::size_t thread_slot() noexcept
+{
+    thread_local auto slot = next_slot.fetch_add(1, ::std::memory_order_relaxed) % shard_count;
+    return slot;
+}
+} // namespace shared_mutex_detail
+
+// A reader-writer lock for data that is read far more often than written.
+// Readers count themselves in one of shard_count cache-line-sized counters,
+// chosen by thread, so concurrent readers on different threads do not write
+// to a shared cache line. A writer announces itself, then waits until every
+// shard has drained; writers are serialized by a futex_mutex and waiting
+// readers park on a futex until the writer leaves.
+//
+// Writers are preferred: once one is waiting, new readers hold back. The
+// lock is not recursive, and a shared lock must be released on the thread
+// that took it.
+//
+// Only the writer side is profiled: recording shared acquisitions would make
+// every reader write to the same statistics and undo the sharding.
+class shared_mutex
+{
+public:
+    shared_mutex(const shared_mutex &) = delete;
+    shared_mutex &operator=(const shared_mutex &) = delete;
+
+    shared_mutex(shared_mutex &&) = delete;
+    shared_mutex &operator=(shared_mutex &&) = delete;
+
+    constexpr shared_mutex() noexcept = default;
+
+    // Profiled under name when EVQOVV_UTILS_LOCK_PROFILING is defined.
+    explicit shared_mutex(const char *name) : probe_(name)
+    {
+    }
+
+    void lock() noexcept
+    {
+        probe_.acquire([this] { return try_acquire(); }, [this] { acquire(); });
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        return probe_.try_acquire([this] { return try_acquire(); });
+    }
+
+    void unlock() noexcept
+    {
+        probe_.release();
+        release();
+    }
+
+    void lock_shared() noexcept
+    {
+        auto &s = shards_[shared_mutex_detail::thread_slot()];
+        for (;;)
+        {
+            s.readers.fetch_add(1, ::std::memory_order_seq_cst);
+            if (writer_.load(::std::memory_order_seq_cst) == idle) [[likely]]
+            {
+                return;
+            }
+
+            s.readers.fetch_sub(1, ::std::memory_order_release);
+            wait_for_writer();
+        }
+    }
+
+    [[nodiscard]] bool try_lock_shared() noexcept
+    {
+        auto &s = shards_[shared_mutex_detail::thread_slot()];
+        s.readers.fetch_add(1, ::std::memory_order_seq_cst);
+        if (writer_.load(::std::memory_order_seq_cst) == idle) [[likely]]
+        {
+            return true;
+        }
+
+        s.readers.fetch_sub(1, ::std::memory_order_release);
+        return false;
+    }
+
+    void unlock_shared() noexcept
+    {
+        shards_[shared_mutex_detail::thread_slot()].readers.fetch_sub(1, ::std::memory_order_release);
+    }
+
+private:
+    static constexpr ::std::uint32_t idle = 0;
+    static constexpr ::std::uint32_t writing = 1;
+    static constexpr ::std::uint32_t readers_waiting = 2;
+
+    static constexpr int spin_count = 100;
+
+    struct alignas(64) shard
+    {
+        ::std::atomic<::std::uint32_t> readers{0};
+    };
+
+    void wait_for_writer() noexcept
+    {
+        for (int i = 0; i != spin_count; ++i)
+        {
+            cpu_relax();
+            if (writer_.load(::std::memory_order_relaxed) == idle)
+            {
+                return;
+            }
+        }
+
+        auto w = writer_.load(::std::memory_order_relaxed);
+        while (w != idle)
+        {
+            if (w == readers_waiting || writer_.compare_exchange_weak(w, readers_waiting, ::std::memory_order_relaxed))
+            {
+                futex_detail::wait(writer_, readers_waiting);
+                w = writer_.load(::std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void acquire() noexcept
+    {
+        writers_.lock();
+        writer_.store(writing, ::std::memory_order_seq_cst);
+
+        // One budget for the whole drain, so a writer that waits on several
+        // shards still ends up yielding instead of spinning on each.
+        spinlock_detail::backoff b;
+        for (auto &s : shards_)
+        {
+            while (s.readers.load(::std::memory_order_seq_cst) != 0)
+            {
+                b.pause();
+            }
+        }
+    }
+
+    [[nodiscard]] bool try_acquire() noexcept
+    {
+        if (!writers_.try_lock())
+        {
+            return false;
+        }
+
+        writer_.store(writing, ::std::memory_order_seq_cst);
+        for (auto &s : shards_)
+        {
+            if (s.readers.load(::std::memory_order_seq_cst) != 0)
+            {
+                release();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void release() noexcept
+    {
+        if (writer_.exchange(idle, ::std::memory_order_release) == readers_waiting)
+        {
+            futex_detail::wake(writer_, INT_MAX);
+        }
+
+        writers_.unlock();
+    }
+
+    shard shards_[shared_mutex_detail::shard_count];
+
+    alignas(64) ::std::atomic<::std::uint32_t> writer_{idle};
+
+    futex_mutex writers_;
+
+    [[no_unique_address]] lock_profiling_detail::lock_probe probe_;
+};
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
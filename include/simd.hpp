@@ -0,0 +1,434 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace evqovv
+{
+namespace utils
+{
+// Kernels behind the comparison and erase algorithms of the containers when
+// they hold arithmetic elements. On x86 they pick SSE2 or AVX2 at run time;
+// elsewhere they fall back to scalar loops.
+namespace simd_detail
+{
+#if defined(__x86_64__) || defined(__i386__)
+[[nodiscard]] inline bool has_avx2() noexcept
+{
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+// SSE2 is part of x86-64 but optional on 32-bit x86.
+[[nodiscard]] inline bool has_sse2() noexcept
+{
+#if defined(__x86_64__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("sse2");
+    return supported;
+#endif
+}
+
+__attribute__((target("avx2"))) inline ::std::size_t mismatch_bytes_avx2(const unsigned char *a,
+                                                                         const unsigned char *b,
+                                                                         ::std::size_t n) noexcept
+{
+    ::std::size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+        if (mask != 0xFFFFFFFFu)
+        {
+            return i + static_cast<::std::size_t>(__builtin_ctz(~mask));
+        }
+    }
+
+    for (; i != n && a[i] == b[i]; ++i)
+    {
+    }
+
+    return i;
+}
+
+__attribute__((target("sse2"))) inline ::std::size_t mismatch_bytes_sse2(const unsigned char *a,
+                                                                         const unsigned char *b,
+                                                                         ::std::size_t n) noexcept
+{
+    ::std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        if (mask != 0xFFFFu)
+        {
+            return i + static_cast<::std::size_t>(__builtin_ctz(~mask & 0xFFFFu));
+        }
+    }
+
+    for (; i != n && a[i] == b[i]; ++i)
+    {
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2"))) inline bool equal_f32_avx2(const float *a, const float *b, ::std::size_t n) noexcept
+{
+    ::std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), _CMP_EQ_OQ)) != 0xFF)
+        {
+            return false;
+        }
+    }
+
+    for (; i != n; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+__attribute__((target("avx2"))) inline bool equal_f64_avx2(const double *a, const double *b, ::std::size_t n) noexcept
+{
+    ::std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), _CMP_EQ_OQ)) != 0xF)
+        {
+            return false;
+        }
+    }
+
+    for (; i != n; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct compress_table
+{
+    ::std::uint32_t lanes[256][8];
+};
+
+// lanes[mask] lists the indices of the set bits of mask, lowest first, so
+// _mm256_permutevar8x32 packs the kept lanes of a block to the front.
+[[nodiscard]] constexpr compress_table make_compress_table() noexcept
+{
+    compress_table table{};
+    for (unsigned mask = 0; mask != 256; ++mask)
+    {
+        unsigned out = 0;
+        for (unsigned lane = 0; lane != 8; ++lane)
+        {
+            if (mask & (1u << lane))
+            {
+                table.lanes[mask][out++] = lane;
+            }
+        }
+    }
+
+    return table;
+}
+
+inline constexpr compress_table compress_lanes = make_compress_table();
+
+// Removes every 32-bit element equal to value (integer or float comparison)
+// from [p, p + n) and returns the number of elements kept.
+template <bool IsFloat>
+__attribute__((target("avx2"))) ::std::size_t remove_32_avx2(void *data, ::std::size_t n, const void *value) noexcept
+{
+    auto p = static_cast<unsigned char *>(data);
+    ::std::size_t i = 0;
+    ::std::size_t out = 0;
+
+    if constexpr (IsFloat)
+    {
+        float v;
+        ::std::memcpy(&v, value, sizeof(v));
+        auto needle = _mm256_set1_ps(v);
+        for (; i + 8 <= n; i += 8)
+        {
+            auto block = _mm256_loadu_ps(reinterpret_cast<const float *>(p + i * 4));
+            auto keep = static_cast<unsigned>(~_mm256_movemask_ps(_mm256_cmp_ps(block, needle, _CMP_EQ_OQ)) & 0xFF);
+            auto perm = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(compress_lanes.lanes[keep]));
+            _mm256_storeu_ps(reinterpret_cast<float *>(p + out * 4), _mm256_permutevar8x32_ps(block, perm));
+            out += static_cast<::std::size_t>(__builtin_popcount(keep));
+        }
+
+        for (; i != n; ++i)
+        {
+            float x;
+            ::std::memcpy(&x, p + i * 4, 4);
+            ::std::memcpy(p + out * 4, &x, 4);
+            out += x != v;
+        }
+    }
+    else
+    {
+        ::std::int32_t v;
+        ::std::memcpy(&v, value, sizeof(v));
+        auto needle = _mm256_set1_epi32(v);
+        for (; i + 8 <= n; i += 8)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i * 4));
+            auto eq = _mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle));
+            auto keep = static_cast<unsigned>(~_mm256_movemask_ps(eq) & 0xFF);
+            auto perm = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(compress_lanes.lanes[keep]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + out * 4), _mm256_permutevar8x32_epi32(block, perm));
+            out += static_cast<::std::size_t>(__builtin_popcount(keep));
+        }
+
+        for (; i != n; ++i)
+        {
+            ::std::int32_t x;
+            ::std::memcpy(&x, p + i * 4, 4);
+            ::std::memcpy(p + out * 4, &x, 4);
+            out += x != v;
+        }
+    }
+
+    return out;
+}
+
+// Compares the 16 bytes at p element-wise with needle and returns a byte mask
+// with all bytes of the equal elements set.
+template <typename T>
+__attribute__((target("sse2"))) unsigned equal_mask_sse2(const T *p, const T &needle) noexcept
+{
+    __m128i eq;
+    if constexpr (::std::is_same_v<T, float>)
+    {
+        eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p), _mm_set1_ps(needle)));
+    }
+    else if constexpr (::std::is_same_v<T, double>)
+    {
+        eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(p), _mm_set1_pd(needle)));
+    }
+    else
+    {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        if constexpr (sizeof(T) == 1)
+        {
+            eq = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(needle)));
+        }
+        else if constexpr (sizeof(T) == 2)
+        {
+            eq = _mm_cmpeq_epi16(block, _mm_set1_epi16(static_cast<short>(needle)));
+        }
+        else if constexpr (sizeof(T) == 4)
+        {
+            eq = _mm_cmpeq_epi32(block, _mm_set1_epi32(static_cast<int>(needle)));
+        }
+        else
+        {
+            // No 64-bit compare in SSE2: both 32-bit halves must match.
+            auto eq32 = _mm_cmpeq_epi32(block, _mm_set1_epi64x(static_cast<long long>(needle)));
+            eq = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+
+    return static_cast<unsigned>(_mm_movemask_epi8(eq));
+}
+
+// Removes every element equal to value from [p, p + n) and returns the number
+// of elements kept. SSE2 has no lane compaction, so blocks without a match
+// are stored whole, blocks of matches are skipped and only mixed blocks are
+// compacted element by element.
+template <typename T>
+__attribute__((target("sse2"))) ::std::size_t remove_sse2(T *p, ::std::size_t n, const T &value) noexcept
+{
+    constexpr ::std::size_t lanes = 16 / sizeof(T);
+
+    ::std::size_t i = 0;
+    ::std::size_t out = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        auto eq = equal_mask_sse2(p + i, value);
+        if (eq == 0)
+        {
+            // Only bytes of this or earlier blocks are overwritten.
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p + out), _mm_loadu_si128(reinterpret_cast<__m128i *>(p + i)));
+            out += lanes;
+        }
+        else if (eq != 0xFFFFu)
+        {
+            for (::std::size_t j = 0; j != lanes; ++j)
+            {
+                auto x = p[i + j];
+                p[out] = x;
+                out += !(eq & (1u << (j * sizeof(T))));
+            }
+        }
+    }
+
+    for (; i != n; ++i)
+    {
+        auto x = p[i];
+        p[out] = x;
+        out += !(x == value);
+    }
+
+    return out;
+}
+#endif
+
+// Returns the index of the first differing byte, or n if there is none.
+[[nodiscard]] inline ::std::size_t mismatch_bytes(const void *a, const void *b, ::std::size_t n) noexcept
+{
+    auto pa = static_cast<const unsigned char *>(a);
+    auto pb = static_cast<const unsigned char *>(b);
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (has_avx2())
+    {
+        return mismatch_bytes_avx2(pa, pb, n);
+    }
+
+    if (has_sse2())
+    {
+        return mismatch_bytes_sse2(pa, pb, n);
+    }
+#endif
+    ::std::size_t i = 0;
+    for (; i != n && pa[i] == pb[i]; ++i)
+    {
+    }
+
+    return i;
+}
+
+template <typename T>
+[[nodiscard]] bool equal(const T *a, const T *b, ::std::size_t n) noexcept
+{
+    static_assert(::std::is_arithmetic_v<T>);
+
+    if constexpr (::std::is_integral_v<T>)
+    {
+        return mismatch_bytes(a, b, n * sizeof(T)) == n * sizeof(T);
+    }
+    else
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if constexpr (::std::is_same_v<T, float>)
+        {
+            if (has_avx2())
+            {
+                return equal_f32_avx2(a, b, n);
+            }
+        }
+        else if constexpr (::std::is_same_v<T, double>)
+        {
+            if (has_avx2())
+            {
+                return equal_f64_avx2(a, b, n);
+            }
+        }
+#endif
+        for (::std::size_t i = 0; i != n; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+// Lexicographic three-way comparison of two integral ranges: the bytes are
+// scanned for the first difference and only that element is compared.
+template <typename T>
+[[nodiscard]] auto compare(const T *a, ::std::size_t na, const T *b, ::std::size_t nb) noexcept
+{
+    static_assert(::std::is_integral_v<T>);
+
+    auto n = na < nb ? na : nb;
+    auto i = mismatch_bytes(a, b, n * sizeof(T)) / sizeof(T);
+    if (i != n)
+    {
+        return a[i] <=> b[i];
+    }
+
+    return na <=> nb;
+}
+
+// Removes every element equal to value from [p, p + n), keeping the order of
+// the rest, and returns the number of elements kept.
+template <typename T>
+[[nodiscard]] ::std::size_t remove(T *p, ::std::size_t n, const T &value) noexcept
+{
+    static_assert(::std::is_arithmetic_v<T>);
+
+#if defined(__x86_64__) || defined(__i386__)
+    if constexpr (sizeof(T) == 4)
+    {
+        if (has_avx2())
+        {
+            return remove_32_avx2<::std::is_floating_point_v<T>>(p, n, &value);
+        }
+    }
+
+    if constexpr (sizeof(T) <= 8)
+    {
+        if (has_sse2())
+        {
+            return remove_sse2(p, n, value);
+        }
+    }
+#endif
+
+    auto needle = value;
+    ::std::size_t out = 0;
+    for (::std::size_t i = 0; i != n; ++i)
+    {
+        auto x = p[i];
+        p[out] = x;
+        out += !(x == needle);
+    }
+
+    return out;
+}
+
+// Branch-free compaction for trivially copyable elements: every element is
+// written to the output cursor and the cursor only advances when it is kept.
+template <typename T, typename Pred>
+[[nodiscard]] ::std::size_t remove_if(T *p, ::std::size_t n, Pred &pred)
+{
+    static_assert(::std::is_trivially_copyable_v<T>);
+
+    ::std::size_t out = 0;
+    for (::std::size_t i = 0; i != n; ++i)
+    {
+        auto x = p[i];
+        p[out] = x;
+        out += !static_cast<bool>(pred(x));
+    }
+
+    return out;
+}
+} // namespace simd_detail
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,838 @@
+#pragma once
+
+#include "vector.hpp"
+
+namespace evqovv
+{
+namespace utils
+{
+// A vector that keeps its first N elements inside the object and only
+// allocates once it outgrows them. Growth, insertion and erasure follow the
+// same construction/relocation rules as vector, so the exception guarantees
+// match.
+template <typename T, ::std::size_t N, typename Alloc = ::std::allocator<T>>
+class small_vector
+{
+    using atraits_t = ::std::allocator_traits<Alloc>;
+
+    static_assert(::std::is_same_v<typename atraits_t::pointer, T *>,
+                  "small_vector requires an allocator that hands out raw pointers.");
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = typename atraits_t::size_type;
+    using difference_type = typename atraits_t::difference_type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+    using reverse_iterator = ::std::reverse_iterator<iterator>;
+    using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    explicit small_vector(const Alloc &alloc) noexcept : data_(inline_data()), cap_(N), alloc_(alloc)
+    {
+    }
+
+    small_vector() noexcept(noexcept(Alloc())) : small_vector(Alloc())
+    {
+    }
+
+    template <::std::input_iterator InputIt>
+    small_vector(InputIt first, InputIt last, const Alloc &alloc = Alloc()) : small_vector(alloc)
+    {
+        assign(first, last);
+    }
+
+    small_vector(::std::initializer_list<value_type> init, const Alloc &alloc = Alloc())
+        : small_vector(init.begin(), init.end(), alloc)
+    {
+    }
+
+    small_vector(const small_vector &other)
+        : small_vector(atraits_t::select_on_container_copy_construction(other.alloc_))
+    {
+        assign(other.cbegin(), other.cend());
+    }
+
+    small_vector(small_vector &&other) noexcept(is_trivially_relocatable_v<value_type> ||
+                                                ::std::is_nothrow_move_constructible_v<value_type>)
+        : small_vector(other.alloc_)
+    {
+        steal(other);
+    }
+
+    explicit small_vector(size_type count, const value_type &value = value_type(), const Alloc &alloc = Alloc())
+        : small_vector(alloc)
+    {
+        assign(count, value);
+    }
+
+    ~small_vector()
+    {
+        destroy_and_deallocate();
+    }
+
+    void assign(size_type count, const T &value)
+    {
+        if (cap_ < count)
+        {
+            vector_detail::raw_memory raw(alloc_, count);
+            auto raw_p = raw.get();
+            vector_detail::uninitialized_fill(alloc_, raw_p, raw_p + count, value);
+            destroy_and_deallocate();
+            data_ = raw.release();
+            size_ = count;
+            cap_ = count;
+            return;
+        }
+
+        auto common = count < size_ ? count : size_;
+        ::std::fill(data_, data_ + common, value);
+
+        if (count < size_)
+        {
+            truncate_to(count);
+        }
+        else
+        {
+            vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + count, value);
+            size_ = count;
+        }
+    }
+
+    template <::std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        if constexpr (::std::forward_iterator<InputIt>)
+        {
+            auto count = static_cast<size_type>(::std::distance(first, last));
+            if (cap_ < count)
+            {
+                vector_detail::raw_memory raw(alloc_, count);
+                auto raw_p = raw.get();
+                vector_detail::uninitialized_copy(alloc_, first, last, raw_p);
+                destroy_and_deallocate();
+                data_ = raw.release();
+                size_ = count;
+                cap_ = count;
+                return;
+            }
+
+            auto common = count < size_ ? count : size_;
+            for (auto i = size_type(0); i != common; ++i, (void)++first)
+            {
+                data_[i] = *first;
+            }
+
+            if (count < size_)
+            {
+                truncate_to(count);
+            }
+            else
+            {
+                vector_detail::uninitialized_copy(alloc_, first, last, data_ + size_);
+                size_ = count;
+            }
+        }
+        else
+        {
+            clear();
+            for (; first != last; (void)++first)
+            {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    void assign(::std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+    }
+
+    small_vector &operator=(const small_vector &other)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_copy_assignment::value)
+        {
+            destroy_and_deallocate();
+            reset_to_inline();
+            alloc_ = other.alloc_;
+        }
+
+        assign(other.cbegin(), other.cend());
+
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&other)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_move_assignment::value)
+        {
+            destroy_and_deallocate();
+            reset_to_inline();
+            alloc_ = ::std::move(other.alloc_);
+            steal(other);
+        }
+        else
+        {
+            assign(::std::make_move_iterator(other.begin()), ::std::make_move_iterator(other.end()));
+        }
+
+        return *this;
+    }
+
+    small_vector &operator=(::std::initializer_list<value_type> list)
+    {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        check_bounds(pos < size_);
+
+        return *(data_ + pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        check_bounds(pos < size_);
+
+        return *(data_ + pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos)
+    {
+        return *(data_ + pos);
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const
+    {
+        return *(data_ + pos);
+    }
+
+    [[nodiscard]] constexpr reference front() noexcept
+    {
+        check_bounds(!empty());
+
+        return *data_;
+    }
+
+    [[nodiscard]] constexpr const_reference front() const noexcept
+    {
+        check_bounds(!empty());
+
+        return *data_;
+    }
+
+    [[nodiscard]] constexpr reference front_unchecked() noexcept
+    {
+        return *data_;
+    }
+
+    [[nodiscard]] constexpr const_reference front_unchecked() const noexcept
+    {
+        return *data_;
+    }
+
+    [[nodiscard]] constexpr reference back() noexcept
+    {
+        check_bounds(!empty());
+
+        return *(data_ + size_ - 1);
+    }
+
+    [[nodiscard]] constexpr const_reference back() const noexcept
+    {
+        check_bounds(!empty());
+
+        return *(data_ + size_ - 1);
+    }
+
+    [[nodiscard]] constexpr reference back_unchecked() noexcept
+    {
+        return *(data_ + size_ - 1);
+    }
+
+    [[nodiscard]] constexpr const_reference back_unchecked() const noexcept
+    {
+        return *(data_ + size_ - 1);
+    }
+
+    [[nodiscard]] constexpr pointer data() noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr const_pointer data() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr iterator begin() noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr const_iterator begin() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr const_iterator cbegin() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr iterator end() noexcept
+    {
+        return data_ + size_;
+    }
+
+    [[nodiscard]] constexpr const_iterator end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    [[nodiscard]] constexpr const_iterator cend() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    [[nodiscard]] constexpr reverse_iterator rbegin() noexcept
+    {
+        return ::std::make_reverse_iterator(end());
+    }
+
+    [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept
+    {
+        return ::std::make_reverse_iterator(end());
+    }
+
+    [[nodiscard]] constexpr const_reverse_iterator crbegin() const noexcept
+    {
+        return ::std::make_reverse_iterator(cend());
+    }
+
+    [[nodiscard]] constexpr reverse_iterator rend() noexcept
+    {
+        return ::std::make_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept
+    {
+        return ::std::make_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] constexpr const_reverse_iterator crend() const noexcept
+    {
+        return ::std::make_reverse_iterator(cbegin());
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr size_type max_size() const noexcept
+    {
+        return ::std::numeric_limits<::std::size_t>::max() / sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    [[nodiscard]] bool is_inline() const noexcept
+    {
+        return data_ == inline_data();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    void reserve(size_type required_cap)
+    {
+        if (required_cap <= cap_) [[unlikely]]
+        {
+            return;
+        }
+
+        reallocate(required_cap);
+    }
+
+    void shrink_to_fit()
+    {
+        if (is_inline() || size_ == cap_) [[unlikely]]
+        {
+            return;
+        }
+
+        if (size_ <= N)
+        {
+            auto old_data = data_;
+            auto old_cap = cap_;
+            vector_detail::uninitialized_relocate(alloc_, old_data, old_data + size_, inline_data());
+            if constexpr (!is_trivially_relocatable_v<value_type>)
+            {
+                vector_detail::destroy_range(alloc_, old_data, old_data + size_);
+            }
+            alloc_.deallocate(old_data, old_cap);
+            data_ = inline_data();
+            cap_ = N;
+            return;
+        }
+
+        reallocate(size_);
+    }
+
+    void clear() noexcept
+    {
+        vector_detail::destroy_range(alloc_, begin(), end());
+        size_ = 0;
+    }
+
+    iterator insert(const_iterator pos, const value_type &value)
+    {
+        return emplace_impl(index_of(pos), value);
+    }
+
+    iterator insert(const_iterator pos, T &&value)
+    {
+        return emplace_impl(index_of(pos), ::std::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T &value)
+    {
+        return insert_impl(index_of(pos), count, value);
+    }
+
+    template <::std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        auto pos_i = index_of(pos);
+        if constexpr (::std::forward_iterator<InputIt>)
+        {
+            return insert_impl(pos_i, first, last);
+        }
+        else
+        {
+            for (auto i = pos_i; first != last; (void)++first, (void)++i)
+            {
+                emplace_impl(i, *first);
+            }
+
+            return data_ + pos_i;
+        }
+    }
+
+    iterator insert(const_iterator pos, ::std::initializer_list<T> list)
+    {
+        return insert_impl(index_of(pos), list.begin(), list.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args)
+    {
+        return emplace_impl(index_of(pos), ::std::forward<Args>(args)...);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase_impl(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return erase_impl(first, last);
+    }
+
+    void push_back(const T &value)
+    {
+        (void)emplace_back_impl(value);
+    }
+
+    void push_back(T &&value)
+    {
+        (void)emplace_back_impl(::std::move(value));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args &&...args)
+    {
+        return *emplace_back_impl(::std::forward<Args>(args)...);
+    }
+
+    void pop_back()
+    {
+        check_bounds(!empty());
+
+        vector_detail::destroy_at(alloc_, data_ + size_ - 1);
+        --size_;
+    }
+
+    void resize(size_type new_size)
+    {
+        if (new_size < size_)
+        {
+            truncate_to(new_size);
+        }
+
+        if (new_size > size_)
+        {
+            reserve(new_size);
+            vector_detail::uninitialized_default_construct(alloc_, data_ + size_, data_ + new_size);
+            size_ = new_size;
+        }
+    }
+
+    void resize(size_type new_size, const value_type &value)
+    {
+        if (new_size < size_)
+        {
+            truncate_to(new_size);
+        }
+
+        if (new_size > size_)
+        {
+            reserve(new_size);
+            vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + new_size, value);
+            size_ = new_size;
+        }
+    }
+
+    void swap(small_vector &other)
+    {
+        if (!is_inline() && !other.is_inline())
+        {
+            using ::std::swap;
+
+            swap(data_, other.data_);
+            swap(size_, other.size_);
+            swap(cap_, other.cap_);
+
+            if constexpr (atraits_t::propagate_on_container_swap::value)
+            {
+                swap(alloc_, other.alloc_);
+            }
+
+            return;
+        }
+
+        small_vector tmp(::std::move(other));
+        other = ::std::move(*this);
+        *this = ::std::move(tmp);
+    }
+
+private:
+    [[nodiscard]] pointer inline_data() noexcept
+    {
+        return reinterpret_cast<pointer>(buffer_);
+    }
+
+    [[nodiscard]] const_pointer inline_data() const noexcept
+    {
+        return reinterpret_cast<const_pointer>(buffer_);
+    }
+
+    void reset_to_inline() noexcept
+    {
+        data_ = inline_data();
+        size_ = 0;
+        cap_ = N;
+    }
+
+    // Takes over other's elements; this must be empty and inline.
+    void steal(small_vector &other)
+    {
+        if (other.is_inline())
+        {
+            vector_detail::uninitialized_relocate(alloc_, other.begin(), other.end(), data_);
+            size_ = other.size_;
+            if constexpr (!is_trivially_relocatable_v<value_type>)
+            {
+                other.clear();
+            }
+            other.size_ = 0;
+        }
+        else
+        {
+            data_ = ::std::exchange(other.data_, other.inline_data());
+            size_ = ::std::exchange(other.size_, 0);
+            cap_ = ::std::exchange(other.cap_, N);
+        }
+    }
+
+    [[nodiscard]] size_type next_capacity(size_type required)
+    {
+        return static_cast<size_type>(default_growth::next_capacity<value_type>(cap_, required));
+    }
+
+    [[nodiscard]] size_type index_of(const_iterator pos) const
+    {
+        auto idx = static_cast<size_type>(pos - cbegin());
+        if (idx > size_) [[unlikely]]
+        {
+            terminate();
+        }
+
+        return idx;
+    }
+
+    iterator insert_impl(size_type pos_i, size_type count, const value_type &value)
+    {
+        if (cap_ < size_ + count)
+        {
+            auto new_cap = next_capacity(size_ + count);
+            vector_detail::raw_memory raw(alloc_, new_cap);
+            auto raw_p = raw.get();
+            vector_detail::uninitialized_fill(alloc_, raw_p + pos_i, raw_p + pos_i + count, value);
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
+            deallocate_relocated();
+            data_ = raw.release();
+            size_ += count;
+            cap_ = new_cap;
+        }
+        else
+        {
+            auto old_end = data_ + size_;
+            vector_detail::uninitialized_fill(alloc_, old_end, old_end + count, value);
+            size_ += count;
+            ::std::rotate(data_ + pos_i, old_end, data_ + size_);
+        }
+
+        return data_ + pos_i;
+    }
+
+    template <typename It>
+    iterator insert_impl(size_type pos_i, It b, It e)
+    {
+        auto count = static_cast<size_type>(::std::distance(b, e));
+        if (cap_ < size_ + count)
+        {
+            auto new_cap = next_capacity(size_ + count);
+            vector_detail::raw_memory raw(alloc_, new_cap);
+            auto raw_p = raw.get();
+            vector_detail::uninitialized_copy(alloc_, b, e, raw_p + pos_i);
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
+            deallocate_relocated();
+            data_ = raw.release();
+            size_ += count;
+            cap_ = new_cap;
+        }
+        else
+        {
+            auto old_end = data_ + size_;
+            vector_detail::uninitialized_copy(alloc_, b, e, old_end);
+            size_ += count;
+            ::std::rotate(data_ + pos_i, old_end, data_ + size_);
+        }
+
+        return data_ + pos_i;
+    }
+
+    template <typename... Args>
+    iterator emplace_impl(size_type pos_i, Args &&...args)
+    {
+        if (cap_ < size_ + 1)
+        {
+            auto new_cap = next_capacity(size_ + 1);
+            vector_detail::raw_memory raw(alloc_, new_cap);
+            auto raw_p = raw.get();
+            vector_detail::construct_at(alloc_, raw_p + pos_i, ::std::forward<Args>(args)...);
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + 1);
+            deallocate_relocated();
+            data_ = raw.release();
+            ++size_;
+            cap_ = new_cap;
+        }
+        else
+        {
+            auto old_end = data_ + size_;
+            vector_detail::construct_at(alloc_, old_end, ::std::forward<Args>(args)...);
+            ++size_;
+            ::std::rotate(data_ + pos_i, old_end, data_ + size_);
+        }
+
+        return data_ + pos_i;
+    }
+
+    template <typename... Args>
+    iterator emplace_back_impl(Args &&...args)
+    {
+        if (cap_ < size_ + 1)
+        {
+            auto new_cap = next_capacity(size_ + 1);
+            vector_detail::raw_memory raw(alloc_, new_cap);
+            auto raw_p = raw.get();
+            vector_detail::construct_at(alloc_, raw_p + size_, ::std::forward<Args>(args)...);
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + size_, raw_p);
+            deallocate_relocated();
+            data_ = raw.release();
+            ++size_;
+            cap_ = new_cap;
+        }
+        else
+        {
+            vector_detail::construct_at(alloc_, data_ + size_, ::std::forward<Args>(args)...);
+            ++size_;
+        }
+
+        return data_ + size_ - 1;
+    }
+
+    iterator erase_impl(const_iterator first, const_iterator last)
+    {
+        auto erase_count = last - first;
+        auto dst = const_cast<iterator>(first);
+        auto src = dst + erase_count;
+        auto old_end = data_ + size_;
+
+        for (; src != old_end; (void)++dst, (void)++src)
+        {
+            *dst = ::std::move(*src);
+        }
+
+        vector_detail::destroy_range(alloc_, old_end - erase_count, old_end);
+
+        size_ -= erase_count;
+
+        return const_cast<iterator>(first);
+    }
+
+    void destroy_and_deallocate()
+    {
+        vector_detail::destroy_range(alloc_, begin(), end());
+        if (!is_inline())
+        {
+            alloc_.deallocate(data_, cap_);
+        }
+    }
+
+    // Frees the buffer after its elements were moved out by
+    // uninitialized_relocate; the inline buffer is never deallocated.
+    void deallocate_relocated()
+    {
+        if constexpr (!is_trivially_relocatable_v<value_type>)
+        {
+            vector_detail::destroy_range(alloc_, begin(), end());
+        }
+
+        if (!is_inline())
+        {
+            alloc_.deallocate(data_, cap_);
+        }
+    }
+
+    void reallocate(size_type new_cap)
+    {
+        vector_detail::raw_memory raw(alloc_, new_cap);
+        auto raw_p = raw.get();
+        vector_detail::uninitialized_relocate(alloc_, begin(), end(), raw_p);
+
+        deallocate_relocated();
+
+        data_ = raw.release();
+        cap_ = new_cap;
+    }
+
+    void truncate_to(size_type new_size) noexcept
+    {
+        vector_detail::destroy_range(alloc_, data_ + new_size, data_ + size_);
+        size_ = new_size;
+    }
+
+    pointer data_{};
+
+    size_type size_{};
+
+    size_type cap_{};
+
+    [[no_unique_address]] Alloc alloc_{};
+
+    alignas(T) unsigned char buffer_[N == 0 ? 1 : N * sizeof(T)];
+};
+
+template <typename T, ::std::size_t N, typename Alloc>
+void swap(small_vector<T, N, Alloc> &lhs, small_vector<T, N, Alloc> &rhs)
+{
+    lhs.swap(rhs);
+}
+
+template <typename T, ::std::size_t N, typename Alloc>
+bool operator==(const small_vector<T, N, Alloc> &lhs, const small_vector<T, N, Alloc> &rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (decltype(lhs.size()) i = 0; i != lhs.size(); ++i)
+    {
+        if (lhs.index_unchecked(i) != rhs.index_unchecked(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T, ::std::size_t N, typename Alloc>
+constexpr auto operator<=>(const small_vector<T, N, Alloc> &lhs, const small_vector<T, N, Alloc> &rhs)
+{
+    auto min_size = (lhs.size() < rhs.size()) ? lhs.size() : rhs.size();
+    for (decltype(lhs.size()) i = 0; i != min_size; ++i)
+    {
+        auto cmp = lhs.index_unchecked(i) <=> rhs.index_unchecked(i);
+        if (cmp != 0)
+        {
+            return cmp;
+        }
+    }
+
+    return lhs.size() <=> rhs.size();
+}
+
+template <typename T, ::std::size_t N, typename Alloc, typename U = T>
+typename small_vector<T, N, Alloc>::size_type erase(small_vector<T, N, Alloc> &c, const U &value)
+{
+    auto old_size = c.size();
+    c.erase(::std::remove(c.begin(), c.end(), value), c.end());
+    return old_size - c.size();
+}
+
+template <typename T, ::std::size_t N, typename Alloc, typename Pred>
+typename small_vector<T, N, Alloc>::size_type erase_if(small_vector<T, N, Alloc> &c, Pred pred)
+{
+    auto old_size = c.size();
+    c.erase(::std::remove_if(c.begin(), c.end(), pred), c.end());
+    return old_size - c.size();
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,653 @@
+#pragma once
+
+#include "vector.hpp"
+#include <span>
+#include <tuple>
+
+namespace evqovv
+{
+namespace utils
+{
+// A structure-of-arrays container: element i is the row (c0[i], c1[i], ...)
+// and every field lives in its own contiguous, 64-byte aligned column, so a
+// loop over one field touches only that field's cache lines. All columns are
+// carved out of a single allocation and grow together.
+//
+// Growth moves the columns with vector_detail::uninitialized_relocate when
+// every column type relocates without throwing; otherwise it copies them all,
+// so the strong exception guarantee holds either way.
+template <typename Alloc, typename... Ts>
+class basic_soa_vector
+{
+    static_assert(sizeof...(Ts) != 0, "soa_vector needs at least one column.");
+
+public:
+    static constexpr ::std::size_t column_alignment = 64;
+
+private:
+    static_assert(((alignof(Ts) <= column_alignment) && ...), "column types must not be over-aligned.");
+
+    struct alignas(column_alignment) block
+    {
+        unsigned char bytes[column_alignment];
+    };
+
+    using atraits_t = ::std::allocator_traits<Alloc>;
+    using block_allocator_type = typename atraits_t::template rebind_alloc<block>;
+    using block_pointer = typename ::std::allocator_traits<block_allocator_type>::pointer;
+
+    template <typename T>
+    using column_allocator_type = typename atraits_t::template rebind_alloc<T>;
+
+    static constexpr ::std::size_t column_sizes[] = {sizeof(Ts)...};
+
+    static constexpr bool nothrow_relocation =
+        ((is_trivially_relocatable_v<Ts> || ::std::is_nothrow_move_constructible_v<Ts>) && ...);
+
+public:
+    using value_type = ::std::tuple<Ts...>;
+    using allocator_type = Alloc;
+    using size_type = ::std::size_t;
+    using difference_type = ::std::ptrdiff_t;
+    using reference = ::std::tuple<Ts &...>;
+    using const_reference = ::std::tuple<const Ts &...>;
+
+    template <::std::size_t I>
+    using column_type = ::std::tuple_element_t<I, value_type>;
+
+    static constexpr ::std::size_t column_count = sizeof...(Ts);
+
+    explicit basic_soa_vector(const Alloc &alloc) noexcept : alloc_(alloc)
+    {
+    }
+
+    basic_soa_vector() noexcept(noexcept(Alloc())) : basic_soa_vector(Alloc())
+    {
+    }
+
+    basic_soa_vector(const basic_soa_vector &other)
+        : basic_soa_vector(atraits_t::select_on_container_copy_construction(other.alloc_))
+    {
+        if (other.size_ == 0)
+        {
+            return;
+        }
+
+        block_allocator_type ba(alloc_);
+        vector_detail::raw_memory raw(ba, block_count(other.size_));
+        copy_columns(other.data_, other.cap_, raw.get(), other.size_, other.size_,
+                     ::std::index_sequence_for<Ts...>{});
+        data_ = raw.release();
+        size_ = other.size_;
+        cap_ = other.size_;
+    }
+
+    basic_soa_vector(basic_soa_vector &&other) noexcept
+        : data_(::std::exchange(other.data_, nullptr)), size_(::std::exchange(other.size_, 0)),
+          cap_(::std::exchange(other.cap_, 0)), alloc_(::std::move(other.alloc_))
+    {
+    }
+
+    ~basic_soa_vector()
+    {
+        clear();
+        deallocate();
+    }
+
+    basic_soa_vector &operator=(const basic_soa_vector &other)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_copy_assignment::value)
+        {
+            clear();
+            deallocate();
+            data_ = nullptr;
+            cap_ = 0;
+            alloc_ = other.alloc_;
+        }
+
+        assign_columns<false>(other);
+
+        return *this;
+    }
+
+    basic_soa_vector &operator=(basic_soa_vector &&other) noexcept(
+        atraits_t::propagate_on_container_move_assignment::value || atraits_t::is_always_equal::value)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_move_assignment::value)
+        {
+            take_storage(other);
+            alloc_ = ::std::move(other.alloc_);
+        }
+        else
+        {
+            // Allocators that do not propagate, such as polymorphic_allocator,
+            // can still hand over the block when they share a resource.
+            if (alloc_ == other.alloc_)
+            {
+                take_storage(other);
+            }
+            else
+            {
+                assign_columns<true>(other);
+            }
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos) noexcept
+    {
+        return row(pos, ::std::index_sequence_for<Ts...>{});
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const noexcept
+    {
+        return row(pos, ::std::index_sequence_for<Ts...>{});
+    }
+
+    [[nodiscard]] reference back() noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] const_reference back() const noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    template <::std::size_t I>
+    [[nodiscard]] column_type<I> *data() noexcept
+    {
+        return column_data<I>(data_, cap_);
+    }
+
+    template <::std::size_t I>
+    [[nodiscard]] const column_type<I> *data() const noexcept
+    {
+        return column_data<I>(data_, cap_);
+    }
+
+    // The I-th field of every element, contiguous and 64-byte aligned.
+    template <::std::size_t I>
+    [[nodiscard]] ::std::span<column_type<I>> column() noexcept
+    {
+        return {data<I>(), size_};
+    }
+
+    template <::std::size_t I>
+    [[nodiscard]] ::std::span<const column_type<I>> column() const noexcept
+    {
+        return {data<I>(), size_};
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return cap_;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    void reserve(size_type required_cap)
+    {
+        if (required_cap <= cap_) [[unlikely]]
+        {
+            return;
+        }
+
+        reallocate(required_cap);
+    }
+
+    void shrink_to_fit()
+    {
+        if (size_ == cap_) [[unlikely]]
+        {
+            return;
+        }
+
+        if (size_ == 0)
+        {
+            deallocate();
+            data_ = nullptr;
+            cap_ = 0;
+            return;
+        }
+
+        reallocate(size_);
+    }
+
+    void clear() noexcept
+    {
+        destroy_rows(data_, cap_, 0, size_, ::std::index_sequence_for<Ts...>{});
+        size_ = 0;
+    }
+
+    // Appends a row built from one argument per column.
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Ts))
+    reference emplace_back(Args &&...args)
+    {
+        if (cap_ == size_)
+        {
+            // Build the new row in the new block first: args may refer to
+            // elements of the current one.
+            auto new_cap = default_growth::next_capacity<block>(cap_, size_ + 1);
+            block_allocator_type ba(alloc_);
+            vector_detail::raw_memory raw(ba, block_count(new_cap));
+            auto new_data = raw.get();
+            construct_row(new_data, new_cap, size_, ::std::index_sequence_for<Ts...>{}, ::std::forward<Args>(args)...);
+            row_guard guard(*this, new_data, new_cap, size_);
+            transfer_columns(new_data, new_cap);
+            guard.release();
+            release_old_columns();
+            data_ = raw.release();
+            cap_ = new_cap;
+        }
+        else
+        {
+            construct_row(data_, cap_, size_, ::std::index_sequence_for<Ts...>{}, ::std::forward<Args>(args)...);
+        }
+
+        ++size_;
+        return index_unchecked(size_ - 1);
+    }
+
+    void push_back(const Ts &...values)
+    {
+        (void)emplace_back(values...);
+    }
+
+    void pop_back()
+    {
+        check_bounds(!empty());
+
+        destroy_rows(data_, cap_, size_ - 1, size_, ::std::index_sequence_for<Ts...>{});
+        --size_;
+    }
+
+    void swap(basic_soa_vector &other) noexcept
+    {
+        using ::std::swap;
+
+        swap(data_, other.data_);
+        swap(size_, other.size_);
+        swap(cap_, other.cap_);
+
+        if constexpr (atraits_t::propagate_on_container_swap::value)
+        {
+            swap(alloc_, other.alloc_);
+        }
+    }
+
+private:
+    // Destroys the cells of row pos that were built before an exception.
+    class row_guard
+    {
+        basic_soa_vector &v_;
+        block_pointer data_;
+        size_type cap_;
+        size_type pos_;
+        bool flag_ = true;
+
+    public:
+        row_guard(basic_soa_vector &v, block_pointer data, size_type cap, size_type pos) noexcept
+            : v_(v), data_(data), cap_(cap), pos_(pos)
+        {
+        }
+
+        ~row_guard()
+        {
+            if (flag_) [[unlikely]]
+            {
+                v_.destroy_rows(data_, cap_, pos_, pos_ + 1, ::std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        void release() noexcept
+        {
+            flag_ = false;
+        }
+    };
+
+    [[nodiscard]] static constexpr size_type align_up(size_type n) noexcept
+    {
+        return (n + column_alignment - 1) & ~(column_alignment - 1);
+    }
+
+    // Byte offset of column i in a block sized for cap rows; column_offset(N,
+    // cap) is the size of the whole block.
+    [[nodiscard]] static constexpr size_type column_offset(::std::size_t i, size_type cap) noexcept
+    {
+        size_type offset = 0;
+        for (::std::size_t j = 0; j != i; ++j)
+        {
+            offset = align_up(offset + cap * column_sizes[j]);
+        }
+
+        return offset;
+    }
+
+    [[nodiscard]] static constexpr size_type block_count(size_type cap) noexcept
+    {
+        return column_offset(sizeof...(Ts), cap) / column_alignment;
+    }
+
+    template <::std::size_t I>
+    [[nodiscard]] static column_type<I> *column_data(block_pointer blocks, size_type cap) noexcept
+    {
+        auto bytes = reinterpret_cast<unsigned char *>(::std::to_address(blocks));
+        return reinterpret_cast<column_type<I> *>(bytes + column_offset(I, cap));
+    }
+
+    template <::std::size_t... Is>
+    [[nodiscard]] reference row(size_type pos, ::std::index_sequence<Is...>) noexcept
+    {
+        return reference(*(column_data<Is>(data_, cap_) + pos)...);
+    }
+
+    template <::std::size_t... Is>
+    [[nodiscard]] const_reference row(size_type pos, ::std::index_sequence<Is...>) const noexcept
+    {
+        return const_reference(*(column_data<Is>(data_, cap_) + pos)...);
+    }
+
+    template <::std::size_t I, typename Arg>
+    void construct_cell(block_pointer blocks, size_type cap, size_type pos, Arg &&arg)
+    {
+        column_allocator_type<column_type<I>> a(alloc_);
+        vector_detail::construct_at(a, column_data<I>(blocks, cap) + pos, ::std::forward<Arg>(arg));
+    }
+
+    template <::std::size_t... Is, typename... Args>
+    void construct_row(block_pointer blocks, size_type cap, size_type pos, ::std::index_sequence<Is...>,
+                       Args &&...args)
+    {
+        size_type built = 0;
+        cell_guard guard(*this, blocks, cap, pos, built);
+        ((construct_cell<Is>(blocks, cap, pos, ::std::forward<Args>(args)), ++built), ...);
+        guard.release();
+    }
+
+    // Destroys the first built cells of row pos if construct_row throws.
+    class cell_guard
+    {
+        basic_soa_vector &v_;
+        block_pointer data_;
+        size_type cap_;
+        size_type pos_;
+        size_type &built_;
+        bool flag_ = true;
+
+    public:
+        cell_guard(basic_soa_vector &v, block_pointer data, size_type cap, size_type pos, size_type &built) noexcept
+            : v_(v), data_(data), cap_(cap), pos_(pos), built_(built)
+        {
+        }
+
+        ~cell_guard()
+        {
+            if (flag_) [[unlikely]]
+            {
+                v_.destroy_cells(data_, cap_, pos_, built_, ::std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        void release() noexcept
+        {
+            flag_ = false;
+        }
+    };
+
+    template <::std::size_t... Is>
+    void destroy_cells(block_pointer blocks, size_type cap, size_type pos, size_type count,
+                       ::std::index_sequence<Is...>) noexcept
+    {
+        (destroy_column_range<Is>(blocks, cap, pos, Is < count ? pos + 1 : pos), ...);
+    }
+
+    template <::std::size_t I>
+    void destroy_column_range(block_pointer blocks, size_type cap, size_type first, size_type last) noexcept
+    {
+        if (!blocks)
+        {
+            return;
+        }
+
+        column_allocator_type<column_type<I>> a(alloc_);
+        auto col = column_data<I>(blocks, cap);
+        vector_detail::destroy_range(a, col + first, col + last);
+    }
+
+    template <::std::size_t... Is>
+    void destroy_rows(block_pointer blocks, size_type cap, size_type first, size_type last,
+                      ::std::index_sequence<Is...>) noexcept
+    {
+        (destroy_column_range<Is>(blocks, cap, first, last), ...);
+    }
+
+    // Copies rows [0, count) of every column, or moves them if Move is set;
+    // if one column throws, the columns built before it are destroyed again.
+    template <bool Move = false, ::std::size_t... Is>
+    void copy_columns(block_pointer from, size_type from_cap, block_pointer to, size_type to_cap, size_type count,
+                      ::std::index_sequence<Is...>)
+    {
+        size_type built = 0;
+        column_guard guard(*this, to, to_cap, count, built);
+        ((copy_column<Is, Move>(from, from_cap, to, to_cap, count), ++built), ...);
+        guard.release();
+    }
+
+    template <::std::size_t I, bool Move>
+    void copy_column(block_pointer from, size_type from_cap, block_pointer to, size_type to_cap, size_type count)
+    {
+        column_allocator_type<column_type<I>> a(alloc_);
+        auto src = column_data<I>(from, from_cap);
+        if constexpr (Move)
+        {
+            vector_detail::uninitialized_copy(a, ::std::make_move_iterator(src), ::std::make_move_iterator(src + count),
+                                              column_data<I>(to, to_cap));
+        }
+        else
+        {
+            vector_detail::uninitialized_copy(a, src, src + count, column_data<I>(to, to_cap));
+        }
+    }
+
+    // Replaces the rows with copies of other's, or moves other's into them if
+    // Move is set, reusing the current block when it is large enough.
+    template <bool Move>
+    void assign_columns(::std::conditional_t<Move, basic_soa_vector, const basic_soa_vector> &other)
+    {
+        clear();
+        if (cap_ < other.size_)
+        {
+            block_allocator_type ba(alloc_);
+            vector_detail::raw_memory raw(ba, block_count(other.size_));
+            copy_columns<Move>(other.data_, other.cap_, raw.get(), other.size_, other.size_,
+                               ::std::index_sequence_for<Ts...>{});
+            deallocate();
+            data_ = raw.release();
+            cap_ = other.size_;
+        }
+        else if (other.size_ != 0)
+        {
+            copy_columns<Move>(other.data_, other.cap_, data_, cap_, other.size_, ::std::index_sequence_for<Ts...>{});
+        }
+
+        size_ = other.size_;
+    }
+
+    void take_storage(basic_soa_vector &other) noexcept
+    {
+        clear();
+        deallocate();
+        data_ = ::std::exchange(other.data_, nullptr);
+        size_ = ::std::exchange(other.size_, 0);
+        cap_ = ::std::exchange(other.cap_, 0);
+    }
+
+    template <::std::size_t I>
+    void relocate_column(block_pointer to, size_type to_cap)
+    {
+        column_allocator_type<column_type<I>> a(alloc_);
+        auto src = column_data<I>(data_, cap_);
+        vector_detail::uninitialized_relocate(a, src, src + size_, column_data<I>(to, to_cap));
+    }
+
+    // Destroys the first built columns of rows [0, count) if copy_columns
+    // throws.
+    class column_guard
+    {
+        basic_soa_vector &v_;
+        block_pointer data_;
+        size_type cap_;
+        size_type count_;
+        size_type &built_;
+        bool flag_ = true;
+
+    public:
+        column_guard(basic_soa_vector &v, block_pointer data, size_type cap, size_type count, size_type &built) noexcept
+            : v_(v), data_(data), cap_(cap), count_(count), built_(built)
+        {
+        }
+
+        ~column_guard()
+        {
+            if (flag_) [[unlikely]]
+            {
+                v_.destroy_columns(data_, cap_, count_, built_, ::std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        void release() noexcept
+        {
+            flag_ = false;
+        }
+    };
+
+    template <::std::size_t... Is>
+    void destroy_columns(block_pointer blocks, size_type cap, size_type count, size_type columns,
+                         ::std::index_sequence<Is...>) noexcept
+    {
+        (destroy_column_range<Is>(blocks, cap, 0, Is < columns ? count : 0), ...);
+    }
+
+    template <::std::size_t... Is>
+    void relocate_columns(block_pointer to, size_type to_cap, ::std::index_sequence<Is...>)
+    {
+        (relocate_column<Is>(to, to_cap), ...);
+    }
+
+    // Moves the current rows into the block to; the old block still has to be
+    // released with release_old_columns.
+    void transfer_columns(block_pointer to, size_type to_cap)
+    {
+        if constexpr (nothrow_relocation)
+        {
+            relocate_columns(to, to_cap, ::std::index_sequence_for<Ts...>{});
+        }
+        else
+        {
+            copy_columns(data_, cap_, to, to_cap, size_, ::std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    template <::std::size_t I>
+    void release_old_column() noexcept
+    {
+        if constexpr (!nothrow_relocation || !is_trivially_relocatable_v<column_type<I>>)
+        {
+            destroy_column_range<I>(data_, cap_, 0, size_);
+        }
+    }
+
+    template <::std::size_t... Is>
+    void release_old_columns(::std::index_sequence<Is...>) noexcept
+    {
+        (release_old_column<Is>(), ...);
+    }
+
+    void release_old_columns() noexcept
+    {
+        release_old_columns(::std::index_sequence_for<Ts...>{});
+        deallocate();
+    }
+
+    void deallocate() noexcept
+    {
+        if (data_) [[likely]]
+        {
+            block_allocator_type ba(alloc_);
+            ba.deallocate(data_, block_count(cap_));
+        }
+    }
+
+    void reallocate(size_type new_cap)
+    {
+        block_allocator_type ba(alloc_);
+        vector_detail::raw_memory raw(ba, block_count(new_cap));
+        transfer_columns(raw.get(), new_cap);
+        release_old_columns();
+        data_ = raw.release();
+        cap_ = new_cap;
+    }
+
+    block_pointer data_{};
+
+    size_type size_{};
+
+    size_type cap_{};
+
+    [[no_unique_address]] Alloc alloc_{};
+};
+
+template <typename... Ts>
+using soa_vector = basic_soa_vector<::std::allocator<::std::byte>, Ts...>;
+
+template <typename Alloc, typename... Ts>
+void swap(basic_soa_vector<Alloc, Ts...> &lhs, basic_soa_vector<Alloc, Ts...> &rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "helper.hpp"
+#include "lock_profiling.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sched.h>
+
+namespace evqovv
+{
+namespace utils
+{
+namespace spinlock_detail
+{
+// Exponential backoff for spin loops: every round pauses twice as long as the
+// previous one, up to max_spins pauses. Rounds at the cap continue for
+// capped_rounds more; the roughly 200 pauses in total take a few microseconds,
+// about the cost of a context switch, and cover lock hand-offs between running
+// threads on many-core machines without a system call. After that the waiter
+// yields the CPU on every round, since the thread being waited for has then
+// likely been preempted; with more threads than cores, a fair lock would
+// otherwise stall until the scheduler gets to it.
+class backoff
+{
+public:
+    static constexpr ::std::uint32_t max_spins = 32;
+
+    static constexpr ::std::uint32_t capped_rounds = 4;
+
+    void pause() noexcept
+    {
+        if (capped_ == capped_rounds)
+        {
+            ::sched_yield();
+            return;
+        }
+
+        for (::std::uint32_t i = 0; i != spins_; ++i)
+        {
+            cpu_relax();
+        }
+
+        if (spins_ < max_spins)
+        {
+            spins_ *= 2;
+        }
+        else
+        {
+            ++capped_;
+        }
+    }
+
+private:
+    ::std::uint32_t spins_ = 1;
+
+    ::std::uint32_t capped_ = 0;
+};
+} // namespace spinlock_detail
+
+// A FIFO spinlock for short critical sections. A thread takes a ticket and
+// waits until it is served, so waiters are granted the lock in arrival order
+// and cannot starve. All waiters spin on the same word; for many cores, see
+// mcs_lock.
+class ticket_lock
+{
+public:
+    ticket_lock(const ticket_lock &) = delete;
+    ticket_lock &operator=(const ticket_lock &) = delete;
+
+    ticket_lock(ticket_lock &&) = delete;
+    ticket_lock &operator=(ticket_lock &&) = delete;
+
+    constexpr ticket_lock() noexcept = default;
+
+    // Profiled under name when EVQOVV_UTILS_LOCK_PROFILING is defined.
+    explicit ticket_lock(const char *name) : probe_(name)
+    {
+    }
+
+    void lock() noexcept
+    {
+        probe_.acquire([this] { return try_acquire(); }, [this] { acquire(); });
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        return probe_.try_acquire([this] { return try_acquire(); });
+    }
+
+    void unlock() noexcept
+    {
+        probe_.release();
+        serving_.store(serving_.load(::std::memory_order_relaxed) + 1, ::std::memory_order_release);
+    }
+
+private:
+    void acquire() noexcept
+    {
+        auto ticket = next_.fetch_add(1, ::std::memory_order_relaxed);
+        spinlock_detail::backoff b;
+        while (serving_.load(::std::memory_order_acquire) != ticket)
+        {
+            b.pause();
+        }
+    }
+
+    [[nodiscard]] bool try_acquire() noexcept
+    {
+        // unlock() only releases through serving_, so the acquire has to be
+        // on this load rather than on next_.
+        auto ticket = serving_.load(::std::memory_order_acquire);
+        return next_.compare_exchange_strong(ticket, ticket + 1, ::std::memory_order_relaxed,
+                                             ::std::memory_order_relaxed);
+    }
+
+    ::std::atomic<::std::uint32_t> next_{0};
+
+    ::std::atomic<::std::uint32_t> serving_{0};
+
+    [[no_unique_address]] lock_profiling_detail::lock_probe probe_;
+};
+
+class mcs_lock;
+
+namespace spinlock_detail
+{
+struct alignas(64) mcs_node
+{
+    ::std::atomic<mcs_node *> next;
+    ::std::atomic<bool> waiting;
+    const mcs_lock *owner;
+};
+
+// Queue nodes of the MCS locks held or awaited by this thread. A thread can
+// hold up to max_held of them at once, released in any order.
+inline constexpr ::std::size_t max_held = 16;
+
+inline thread_local constinit mcs_node held_nodes[max_held]{};
+
+[[nodiscard]] inline mcs_node *acquire_node(const mcs_lock *owner) noexcept
+{
+    for (auto &n : held_nodes)
+    {
+        if (!n.owner)
+        {
+            n.owner = owner;
+            return &n;
+        }
+    }
+
+    terminate();
+}
+
+[[nodiscard]] inline mcs_node *find_node(const mcs_lock *owner) noexcept
+{
+    for (auto &n : held_nodes)
+    {
+        if (n.owner == owner)
+        {
+            return &n;
+        }
+    }
+
+    terminate();
+}
+} // namespace spinlock_detail
+
+// The MCS queue lock. Waiters form a linked list and each spins on a flag in
+// its own node, so a release touches only the next waiter's cache line instead
+// of every waiter's, and throughput holds up as cores are added. Grants are
+// FIFO. The lock itself is a single pointer; queue nodes live in thread-local
+// storage, so lock and unlock must be called on the same thread.
+class mcs_lock
+{
+public:
+    mcs_lock(const mcs_lock &) = delete;
+    mcs_lock &operator=(const mcs_lock &) = delete;
+
+    mcs_lock(mcs_lock &&) = delete;
+    mcs_lock &operator=(mcs_lock &&) = delete;
+
+    constexpr mcs_lock() noexcept = default;
+
+    // Profiled under name when EVQOVV_UTILS_LOCK_PROFILING is defined.
+    explicit mcs_lock(const char *name) : probe_(name)
+    {
+    }
+
+    void lock() noexcept
+    {
+        probe_.acquire([this] { return try_acquire(); }, [this] { acquire(); });
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        return probe_.try_acquire([this] { return try_acquire(); });
+    }
+
+    void unlock() noexcept
+    {
+        probe_.release();
+        release();
+    }
+
+private:
+    void acquire() noexcept
+    {
+        auto n = prepare_node();
+        auto prev = tail_.exchange(n, ::std::memory_order_acq_rel);
+        if (!prev) [[likely]]
+        {
+            return;
+        }
+
+        n->waiting.store(true, ::std::memory_order_relaxed);
+        prev->next.store(n, ::std::memory_order_release);
+        spinlock_detail::backoff b;
+        while (n->waiting.load(::std::memory_order_acquire))
+        {
+            b.pause();
+        }
+    }
+
+    [[nodiscard]] bool try_acquire() noexcept
+    {
+        auto n = prepare_node();
+        spinlock_detail::mcs_node *expected = nullptr;
+        if (tail_.compare_exchange_strong(expected, n, ::std::memory_order_acquire, ::std::memory_order_relaxed))
+        {
+            return true;
+        }
+
+        n->owner = nullptr;
+        return false;
+    }
+
+    void release() noexcept
+    {
+        auto n = spinlock_detail::find_node(this);
+        auto next = n->next.load(::std::memory_order_acquire);
+        if (!next)
+        {
+            auto expected = n;
+            if (tail_.compare_exchange_strong(expected, nullptr, ::std::memory_order_release,
+                                              ::std::memory_order_relaxed))
+            {
+                n->owner = nullptr;
+                return;
+            }
+
+            // A successor has swapped itself into tail_ but not yet linked
+            // itself behind n.
+            spinlock_detail::backoff b;
+            while (!(next = n->next.load(::std::memory_order_acquire)))
+            {
+                b.pause();
+            }
+        }
+
+        next->waiting.store(false, ::std::memory_order_release);
+        n->owner = nullptr;
+    }
+
+    [[nodiscard]] spinlock_detail::mcs_node *prepare_node() noexcept
+    {
+        auto n = spinlock_detail::acquire_node(this);
+        n->next.store(nullptr, ::std::memory_order_relaxed);
+        return n;
+    }
+
+    ::std::atomic<spinlock_detail::mcs_node *> tail_{nullptr};
+
+    [[no_unique_address]] lock_profiling_detail::lock_probe probe_;
+};
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
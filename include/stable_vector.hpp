@@ -0,0 +1,656 @@
+#pragma once
+
+#include "vector.hpp"
+
+namespace evqovv
+{
+namespace utils
+{
+namespace stable_vector_detail
+{
+template <typename T>
+inline constexpr ::std::size_t default_chunk_size = ::std::bit_floor(4096 / sizeof(T) < 16 ? 16 : 4096 / sizeof(T));
+} // namespace stable_vector_detail
+
+// A vector made of fixed-size chunks addressed through a small directory.
+// Growing only allocates a new chunk, so the address of an element never
+// changes while it stays in the container; only the directory of chunk
+// pointers is ever reallocated. Iterators refer to the container and an
+// index, so they stay valid across growth as well.
+template <typename T, ::std::size_t ChunkSize = stable_vector_detail::default_chunk_size<T>,
+          typename Alloc = ::std::allocator<T>>
+class stable_vector
+{
+    static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two.");
+
+    using atraits_t = ::std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = typename atraits_t::size_type;
+    using difference_type = typename atraits_t::difference_type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = typename atraits_t::pointer;
+    using const_pointer = typename atraits_t::const_pointer;
+
+    static constexpr size_type chunk_size = ChunkSize;
+
+private:
+    template <bool Const>
+    class basic_iterator
+    {
+        friend class stable_vector;
+
+        template <bool>
+        friend class basic_iterator;
+
+        using container_type = ::std::conditional_t<Const, const stable_vector, stable_vector>;
+
+        container_type *c_{};
+        size_type i_{};
+
+        basic_iterator(container_type *c, size_type i) noexcept : c_(c), i_(i)
+        {
+        }
+
+    public:
+        using iterator_category = ::std::random_access_iterator_tag;
+        using iterator_concept = ::std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = typename stable_vector::difference_type;
+        using reference = ::std::conditional_t<Const, const T &, T &>;
+        using pointer = ::std::conditional_t<Const, const T *, T *>;
+
+        basic_iterator() noexcept = default;
+
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst> &other) noexcept : c_(other.c_), i_(other.i_)
+        {
+        }
+
+        [[nodiscard]] reference operator*() const noexcept
+        {
+            return c_->index_unchecked(i_);
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept
+        {
+            return ::std::addressof(c_->index_unchecked(i_));
+        }
+
+        [[nodiscard]] reference operator[](difference_type n) const noexcept
+        {
+            return c_->index_unchecked(i_ + n);
+        }
+
+        basic_iterator &operator++() noexcept
+        {
+            ++i_;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++i_;
+            return tmp;
+        }
+
+        basic_iterator &operator--() noexcept
+        {
+            --i_;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept
+        {
+            auto tmp = *this;
+            --i_;
+            return tmp;
+        }
+
+        basic_iterator &operator+=(difference_type n) noexcept
+        {
+            i_ += n;
+            return *this;
+        }
+
+        basic_iterator &operator-=(difference_type n) noexcept
+        {
+            i_ -= n;
+            return *this;
+        }
+
+        [[nodiscard]] friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept
+        {
+            return it += n;
+        }
+
+        [[nodiscard]] friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        [[nodiscard]] friend difference_type operator-(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return static_cast<difference_type>(lhs.i_) - static_cast<difference_type>(rhs.i_);
+        }
+
+        [[nodiscard]] friend bool operator==(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.i_ == rhs.i_;
+        }
+
+        [[nodiscard]] friend auto operator<=>(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.i_ <=> rhs.i_;
+        }
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = ::std::reverse_iterator<iterator>;
+    using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
+
+    explicit stable_vector(const Alloc &alloc) noexcept : chunks_(chunk_allocator_type(alloc)), alloc_(alloc)
+    {
+    }
+
+    stable_vector() noexcept(noexcept(Alloc())) : stable_vector(Alloc())
+    {
+    }
+
+    template <::std::input_iterator InputIt>
+    stable_vector(InputIt first, InputIt last, const Alloc &alloc = Alloc()) : stable_vector(alloc)
+    {
+        if constexpr (::std::forward_iterator<InputIt>)
+        {
+            reserve(static_cast<size_type>(::std::distance(first, last)));
+        }
+
+        for (; first != last; (void)++first)
+        {
+            emplace_back(*first);
+        }
+    }
+
+    stable_vector(::std::initializer_list<value_type> init, const Alloc &alloc = Alloc())
+        : stable_vector(init.begin(), init.end(), alloc)
+    {
+    }
+
+    stable_vector(const stable_vector &other)
+        : stable_vector(other.begin(), other.end(), atraits_t::select_on_container_copy_construction(other.alloc_))
+    {
+    }
+
+    stable_vector(stable_vector &&other) noexcept
+        : chunks_(::std::move(other.chunks_)), size_(::std::exchange(other.size_, 0)),
+          alloc_(::std::move(other.alloc_))
+    {
+    }
+
+    explicit stable_vector(size_type count, const value_type &value = value_type(), const Alloc &alloc = Alloc())
+        : stable_vector(alloc)
+    {
+        resize(count, value);
+    }
+
+    ~stable_vector()
+    {
+        clear();
+        release_chunks(0);
+    }
+
+    stable_vector &operator=(const stable_vector &other)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_copy_assignment::value)
+        {
+            clear();
+            release_chunks(0);
+            alloc_ = other.alloc_;
+        }
+
+        assign_elements<false>(other);
+
+        return *this;
+    }
+
+    stable_vector &operator=(stable_vector &&other) noexcept(
+        atraits_t::propagate_on_container_move_assignment::value || atraits_t::is_always_equal::value)
+    {
+        if (::std::addressof(other) == this) [[unlikely]]
+        {
+            return *this;
+        }
+
+        if constexpr (atraits_t::propagate_on_container_move_assignment::value)
+        {
+            take_chunks(other);
+            alloc_ = ::std::move(other.alloc_);
+        }
+        else
+        {
+            // Allocators that do not propagate, such as polymorphic_allocator,
+            // can still hand over the chunks when they share a resource.
+            if (alloc_ == other.alloc_)
+            {
+                take_chunks(other);
+            }
+            else
+            {
+                assign_elements<true>(other);
+            }
+        }
+
+        return *this;
+    }
+
+    [[nodiscard]] reference operator[](size_type pos)
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] const_reference operator[](size_type pos) const
+    {
+        check_bounds(pos < size_);
+
+        return index_unchecked(pos);
+    }
+
+    [[nodiscard]] reference index_unchecked(size_type pos)
+    {
+        return *slot(pos);
+    }
+
+    [[nodiscard]] const_reference index_unchecked(size_type pos) const
+    {
+        return *slot(pos);
+    }
+
+    [[nodiscard]] reference front() noexcept
+    {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept
+    {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] reference front_unchecked() noexcept
+    {
+        return index_unchecked(0);
+    }
+
+    [[nodiscard]] const_reference front_unchecked() const noexcept
+    {
+        return index_unchecked(0);
+    }
+
+    [[nodiscard]] reference back() noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] const_reference back() const noexcept
+    {
+        check_bounds(!empty());
+
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] reference back_unchecked() noexcept
+    {
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] const_reference back_unchecked() const noexcept
+    {
+        return index_unchecked(size_ - 1);
+    }
+
+    [[nodiscard]] iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] iterator end() noexcept
+    {
+        return iterator(this, size_);
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return const_iterator(this, size_);
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept
+    {
+        return const_iterator(this, size_);
+    }
+
+    [[nodiscard]] reverse_iterator rbegin() noexcept
+    {
+        return ::std::make_reverse_iterator(end());
+    }
+
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept
+    {
+        return ::std::make_reverse_iterator(end());
+    }
+
+    [[nodiscard]] const_reverse_iterator crbegin() const noexcept
+    {
+        return ::std::make_reverse_iterator(cend());
+    }
+
+    [[nodiscard]] reverse_iterator rend() noexcept
+    {
+        return ::std::make_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] const_reverse_iterator rend() const noexcept
+    {
+        return ::std::make_reverse_iterator(begin());
+    }
+
+    [[nodiscard]] const_reverse_iterator crend() const noexcept
+    {
+        return ::std::make_reverse_iterator(cbegin());
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr size_type max_size() const noexcept
+    {
+        return ::std::numeric_limits<::std::size_t>::max() / sizeof(value_type);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return chunks_.size() * ChunkSize;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+    void reserve(size_type required_cap)
+    {
+        auto required_chunks = (required_cap + ChunkSize - 1) / ChunkSize;
+        if (required_chunks <= chunks_.size())
+        {
+            return;
+        }
+
+        chunks_.reserve(required_chunks);
+        while (chunks_.size() != required_chunks)
+        {
+            add_chunk();
+        }
+    }
+
+    // Frees the chunks past the last element; the remaining elements stay put.
+    void shrink_to_fit()
+    {
+        release_chunks((size_ + ChunkSize - 1) / ChunkSize);
+        chunks_.shrink_to_fit();
+    }
+
+    void clear() noexcept
+    {
+        truncate_to(0);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    // Shifts the following elements down, so like vector::erase this changes
+    // what lives at the addresses after first.
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto dst = first.i_;
+        auto src = last.i_;
+
+        for (; src != size_; ++dst, ++src)
+        {
+            index_unchecked(dst) = ::std::move(index_unchecked(src));
+        }
+
+        truncate_to(dst);
+
+        return iterator(this, first.i_);
+    }
+
+    void push_back(const T &value)
+    {
+        (void)emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+        (void)emplace_back(::std::move(value));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args &&...args)
+    {
+        if (size_ == capacity())
+        {
+            add_chunk();
+        }
+
+        auto p = slot(size_);
+        vector_detail::construct_at(alloc_, p, ::std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    void pop_back()
+    {
+        check_bounds(!empty());
+
+        vector_detail::destroy_at(alloc_, slot(size_ - 1));
+        --size_;
+    }
+
+    void resize(size_type new_size)
+    {
+        truncate_to(new_size < size_ ? new_size : size_);
+        reserve(new_size);
+        while (size_ < new_size)
+        {
+            emplace_back();
+        }
+    }
+
+    void resize(size_type new_size, const value_type &value)
+    {
+        truncate_to(new_size < size_ ? new_size : size_);
+        reserve(new_size);
+        while (size_ < new_size)
+        {
+            emplace_back(value);
+        }
+    }
+
+    void swap(stable_vector &other) noexcept
+    {
+        using ::std::swap;
+
+        chunks_.swap(other.chunks_);
+        swap(size_, other.size_);
+
+        if constexpr (atraits_t::propagate_on_container_swap::value)
+        {
+            swap(alloc_, other.alloc_);
+        }
+    }
+
+private:
+    using chunk_allocator_type = typename atraits_t::template rebind_alloc<pointer>;
+
+    [[nodiscard]] pointer slot(size_type pos) const noexcept
+    {
+        return chunks_.index_unchecked(pos / ChunkSize) + pos % ChunkSize;
+    }
+
+    void add_chunk()
+    {
+        vector_detail::raw_memory raw(alloc_, ChunkSize);
+        chunks_.push_back(raw.get());
+        (void)raw.release();
+    }
+
+    // Makes the elements copies of other's, or moves other's into them if Move
+    // is set, reusing the elements and chunks already in place.
+    template <bool Move>
+    void assign_elements(::std::conditional_t<Move, stable_vector, const stable_vector> &other)
+    {
+        auto common = size_ < other.size_ ? size_ : other.size_;
+        for (size_type i = 0; i != common; ++i)
+        {
+            if constexpr (Move)
+            {
+                index_unchecked(i) = ::std::move(other.index_unchecked(i));
+            }
+            else
+            {
+                index_unchecked(i) = other.index_unchecked(i);
+            }
+        }
+
+        truncate_to(common);
+        reserve(other.size_);
+        for (auto i = common; i != other.size_; ++i)
+        {
+            if constexpr (Move)
+            {
+                emplace_back(::std::move(other.index_unchecked(i)));
+            }
+            else
+            {
+                emplace_back(other.index_unchecked(i));
+            }
+        }
+    }
+
+    // Frees the own chunks and adopts other's. The directory keeps its own
+    // allocator, so moving it may copy the chunk pointers; other's copies are
+    // dropped either way.
+    void take_chunks(stable_vector &other) noexcept
+    {
+        clear();
+        release_chunks(0);
+        chunks_ = ::std::move(other.chunks_);
+        other.chunks_.clear();
+        size_ = ::std::exchange(other.size_, 0);
+    }
+
+    void release_chunks(size_type keep) noexcept
+    {
+        while (chunks_.size() > keep)
+        {
+            alloc_.deallocate(chunks_.back_unchecked(), ChunkSize);
+            chunks_.pop_back();
+        }
+    }
+
+    void truncate_to(size_type new_size) noexcept
+    {
+        while (size_ != new_size)
+        {
+            vector_detail::destroy_at(alloc_, slot(size_ - 1));
+            --size_;
+        }
+    }
+
+    vector<pointer, chunk_allocator_type> chunks_;
+
+    size_type size_{};
+
+    [[no_unique_address]] Alloc alloc_{};
+};
+
+template <typename T, ::std::size_t ChunkSize, typename Alloc>
+void swap(stable_vector<T, ChunkSize, Alloc> &lhs, stable_vector<T, ChunkSize, Alloc> &rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template <typename T, ::std::size_t ChunkSize, typename Alloc>
+bool operator==(const stable_vector<T, ChunkSize, Alloc> &lhs, const stable_vector<T, ChunkSize, Alloc> &rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (decltype(lhs.size()) i = 0; i != lhs.size(); ++i)
+    {
+        if (lhs.index_unchecked(i) != rhs.index_unchecked(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T, ::std::size_t ChunkSize, typename Alloc, typename U = T>
+typename stable_vector<T, ChunkSize, Alloc>::size_type erase(stable_vector<T, ChunkSize, Alloc> &c, const U &value)
+{
+    auto old_size = c.size();
+    c.erase(::std::remove(c.begin(), c.end(), value), c.end());
+    return old_size - c.size();
+}
+
+template <typename T, ::std::size_t ChunkSize, typename Alloc, typename Pred>
+typename stable_vector<T, ChunkSize, Alloc>::size_type erase_if(stable_vector<T, ChunkSize, Alloc> &c, Pred pred)
+{
+    auto old_size = c.size();
+    c.erase(::std::remove_if(c.begin(), c.end(), pred), c.end());
+    return old_size - c.size();
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "helper.hpp"
+#include "mutex.hpp"
+#include "unique_ptr.hpp"
+#include "vector.hpp"
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace evqovv
+{
+namespace utils
+{
+// A thread-caching front end for small allocations. Requests of up to
+// max_size bytes are rounded up to one of class_count size classes; every
+// thread keeps a free list per class and only takes the central pool's lock
+// to move a whole batch of blocks in or out. Since the size of a block is
+// known when it is freed, a block freed on another thread simply joins that
+// thread's cache. A thread returns its cache to the central pool when it
+// exits.
+//
+// Memory held by the central pool is never given back to the system.
+namespace thread_cache_detail
+{
+inline constexpr ::std::size_t max_size = 32768;
+inline constexpr ::std::size_t class_count = 16;
+inline constexpr ::std::size_t max_alignment = 16;
+inline constexpr ::std::size_t batches_per_span = 8;
+
+// 16-byte steps up to 128 bytes, powers of two above.
+[[nodiscard]] constexpr ::std::size_t class_index(::std::size_t bytes) noexcept
+{
+    if (bytes <= 128)
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / 16;
+    }
+
+    return static_cast<::std::size_t>(::std::bit_width(bytes - 1));
+}
+
+[[nodiscard]] constexpr ::std::size_t class_size(::std::size_t c) noexcept
+{
+    return c < 8 ? (c + 1) * 16 : ::std::size_t(256) << (c - 8);
+}
+
+// Number of blocks moved between a thread and the central pool at once.
+[[nodiscard]] constexpr ::std::size_t batch_size(::std::size_t c) noexcept
+{
+    auto n = 4096 / class_size(c);
+    return n < 2 ? 2 : (n > 64 ? 64 : n);
+}
+
+struct node
+{
+    node *next;
+    node *next_batch;
+};
+
+class central_pool
+{
+    struct alignas(64) size_class
+    {
+        mutex lock;
+        node *batches = nullptr;
+    };
+
+public:
+    // Never destroyed: threads may still free blocks during static
+    // destruction.
+    [[nodiscard]] static central_pool &instance()
+    {
+        static auto pool = new central_pool;
+        return *pool;
+    }
+
+    // Returns a null-terminated chain of free blocks of class c.
+    [[nodiscard]] node *fetch(::std::size_t c)
+    {
+        ::std::lock_guard<mutex> guard(classes_[c].lock);
+        if (!classes_[c].batches)
+        {
+            carve(c);
+        }
+
+        auto batch = classes_[c].batches;
+        classes_[c].batches = batch->next_batch;
+        return batch;
+    }
+
+    void release(::std::size_t c, node *batch)
+    {
+        ::std::lock_guard<mutex> guard(classes_[c].lock);
+        batch->next_batch = classes_[c].batches;
+        classes_[c].batches = batch;
+    }
+
+private:
+    void carve(::std::size_t c)
+    {
+        auto size = class_size(c);
+        auto batch = batch_size(c);
+        auto span = static_cast<unsigned char *>(::operator new(size * batch * batches_per_span));
+
+        for (::std::size_t b = 0; b != batches_per_span; ++b)
+        {
+            auto first = span + b * batch * size;
+            for (::std::size_t i = 0; i != batch; ++i)
+            {
+                auto n = reinterpret_cast<node *>(first + i * size);
+                n->next = i + 1 == batch ? nullptr : reinterpret_cast<node *>(first + (i + 1) * size);
+            }
+
+            auto head = reinterpret_cast<node *>(first);
+            head->next_batch = classes_[c].batches;
+            classes_[c].batches = head;
+        }
+    }
+
+    size_class classes_[class_count];
+};
+
+struct free_list
+{
+    node *head;
+    ::std::size_t count;
+};
+
+// Trivially destructible so that it stays usable while other thread_local
+// destructors free memory.
+struct thread_state
+{
+    free_list lists[class_count];
+    bool registered;
+    bool exited;
+};
+
+inline thread_local constinit thread_state state{};
+
+// Detaches the first count blocks of l and hands them to the central pool.
+inline void release_batch(::std::size_t c, free_list &l, ::std::size_t count)
+{
+    auto head = l.head;
+    auto last = head;
+    for (::std::size_t i = 1; i != count; ++i)
+    {
+        last = last->next;
+    }
+
+    l.head = last->next;
+    l.count -= count;
+    last->next = nullptr;
+    central_pool::instance().release(c, head);
+}
+
+struct thread_exit_flusher
+{
+    ~thread_exit_flusher()
+    {
+        for (::std::size_t c = 0; c != class_count; ++c)
+        {
+            auto &l = state.lists[c];
+            if (l.count != 0)
+            {
+                release_batch(c, l, l.count);
+            }
+        }
+
+        state.exited = true;
+    }
+};
+
+inline void register_thread()
+{
+    thread_local thread_exit_flusher flusher;
+    (void)flusher;
+    state.registered = true;
+}
+
+inline void *allocate_slow(::std::size_t c)
+{
+    auto batch = central_pool::instance().fetch(c);
+    if (state.exited) [[unlikely]]
+    {
+        if (batch->next)
+        {
+            central_pool::instance().release(c, batch->next);
+        }
+
+        return batch;
+    }
+
+    if (!state.registered) [[unlikely]]
+    {
+        register_thread();
+    }
+
+    ::std::size_t count = 0;
+    for (auto n = batch->next; n; n = n->next)
+    {
+        ++count;
+    }
+
+    auto &l = state.lists[c];
+    l.head = batch->next;
+    l.count = count;
+    return batch;
+}
+
+[[nodiscard]] inline void *allocate(::std::size_t bytes)
+{
+    if (bytes > max_size) [[unlikely]]
+    {
+        return ::operator new(bytes);
+    }
+
+    auto c = class_index(bytes);
+    auto &l = state.lists[c];
+    if (l.head) [[likely]]
+    {
+        auto n = l.head;
+        l.head = n->next;
+        --l.count;
+        return n;
+    }
+
+    return allocate_slow(c);
+}
+
+inline void deallocate(void *p, ::std::size_t bytes) noexcept
+{
+    if (bytes > max_size) [[unlikely]]
+    {
+        ::operator delete(p, bytes);
+        return;
+    }
+
+    auto c = class_index(bytes);
+    auto n = static_cast<node *>(p);
+    if (state.exited) [[unlikely]]
+    {
+        n->next = nullptr;
+        central_pool::instance().release(c, n);
+        return;
+    }
+
+    if (!state.registered) [[unlikely]]
+    {
+        register_thread();
+    }
+
+    auto &l = state.lists[c];
+    n->next = l.head;
+    l.head = n;
+    if (++l.count >= 2 * batch_size(c)) [[unlikely]]
+    {
+        release_batch(c, l, batch_size(c));
+    }
+}
+} // namespace thread_cache_detail
+
+// Allocator drawing from the thread caches, e.g. for vector<T,
+// thread_cache_allocator<T>>. Over-aligned types bypass the caches.
+template <typename T>
+class thread_cache_allocator
+{
+public:
+    using value_type = T;
+
+    thread_cache_allocator() noexcept = default;
+
+    template <typename U>
+    thread_cache_allocator(const thread_cache_allocator<U> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate(::std::size_t n)
+    {
+        if (n > ::std::numeric_limits<::std::size_t>::max() / sizeof(T)) [[unlikely]]
+        {
+            throw ::std::bad_array_new_length();
+        }
+
+        if constexpr (alignof(T) > thread_cache_detail::max_alignment)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T), ::std::align_val_t(alignof(T))));
+        }
+        else
+        {
+            return static_cast<T *>(thread_cache_detail::allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T *p, ::std::size_t n) noexcept
+    {
+        if constexpr (alignof(T) > thread_cache_detail::max_alignment)
+        {
+            ::operator delete(p, n * sizeof(T), ::std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            thread_cache_detail::deallocate(p, n * sizeof(T));
+        }
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const thread_cache_allocator<T> &, const thread_cache_allocator<U> &) noexcept
+{
+    return true;
+}
+
+// Deleter for objects created by make_thread_cached_unique. The block size is
+// taken from T, so the pointer must not be converted to a base class.
+template <typename T>
+struct thread_cache_deleter
+{
+    constexpr thread_cache_deleter() noexcept = default;
+
+    void operator()(T *p) noexcept
+    {
+        p->~T();
+        thread_cache_allocator<T>().deallocate(p, 1);
+    }
+};
+
+template <typename T, typename... Args>
+    requires(!::std::is_array_v<T>)
+unique_ptr<T, thread_cache_deleter<T>> make_thread_cached_unique(Args &&...args)
+{
+    thread_cache_allocator<T> a;
+    vector_detail::raw_memory raw(a, 1);
+    ::new (static_cast<void *>(raw.get())) T(::std::forward<Args>(args)...);
+    return unique_ptr<T, thread_cache_deleter<T>>(raw.release());
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "helper.hpp"
 #include <concepts>
 #include <cstddef>
 #include <functional>
@@ -369,6 +370,13 @@ unique_ptr<T> make_unique_for_overwrite(::std::size_t size)
 {
     return unique_ptr(new ::std::remove_extent_t<T>[size]);
 }
+
+template <typename T, typename D>
+struct is_trivially_relocatable<unique_ptr<T, D>>
+    : ::std::bool_constant<is_trivially_relocatable_v<typename unique_ptr<T, D>::pointer> &&
+                           is_trivially_relocatable_v<D>>
+{
+};
 #endif
 
 #if __cplusplus == 201703L
@@ -869,6 +877,13 @@ unique_ptr<T> make_unique_for_overwrite(::std::size_t size)
 {
     return unique_ptr(new ::std::remove_extent_t<T>[size]);
 }
+
+template <typename T, typename D>
+struct is_trivially_relocatable<unique_ptr<T, D>>
+    : ::std::bool_constant<is_trivially_relocatable_v<typename unique_ptr<T, D>::pointer> &&
+                           is_trivially_relocatable_v<D>>
+{
+};
 #endif
 } // namespace utils
 } // namespace evqovv
\ No newline at end of file
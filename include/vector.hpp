@@ -1,8 +1,12 @@
 #pragma once
 
 #include "helper.hpp"
+#include "simd.hpp"
+#include "vector_telemetry.hpp"
 #include <algorithm>
+#include <bit>
 #include <compare>
+#include <concepts>
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
@@ -26,11 +30,11 @@ class construction_guard
     bool flag_ = true;
 
 public:
-    construction_guard(Alloc &a, It &cur) noexcept : a_(a), start_(cur), cur_(cur)
+    constexpr construction_guard(Alloc &a, It &cur) noexcept : a_(a), start_(cur), cur_(cur)
     {
     }
 
-    ~construction_guard()
+    constexpr ~construction_guard()
     {
         if (flag_) [[unlikely]]
         {
@@ -41,12 +45,32 @@ public:
         }
     }
 
-    void release() noexcept
+    constexpr void release() noexcept
     {
         flag_ = false;
     }
 };
 
+// Optional allocator extensions. try_expand(p, old_n, new_n) grows a block
+// without moving it and reports whether it succeeded; reallocate(p, old_n, new_n)
+// resizes a block and may move its bytes, so it is only used for trivially
+// relocatable elements.
+template <typename Alloc>
+concept has_try_expand = requires(Alloc &a, typename ::std::allocator_traits<Alloc>::pointer p,
+                                  typename ::std::allocator_traits<Alloc>::size_type n) {
+    {
+        a.try_expand(p, n, n)
+    } -> ::std::same_as<bool>;
+};
+
+template <typename Alloc>
+concept has_reallocate = requires(Alloc &a, typename ::std::allocator_traits<Alloc>::pointer p,
+                                  typename ::std::allocator_traits<Alloc>::size_type n) {
+    {
+        a.reallocate(p, n, n)
+    } -> ::std::same_as<typename ::std::allocator_traits<Alloc>::pointer>;
+};
+
 template <typename Alloc>
 class raw_memory
 {
@@ -60,11 +84,11 @@ class raw_memory
     bool flag_ = true;
 
 public:
-    raw_memory(Alloc &a, size_type cap) : a_(a), data_(a.allocate(cap)), cap_(cap)
+    constexpr raw_memory(Alloc &a, size_type cap) : a_(a), data_(a.allocate(cap)), cap_(cap)
     {
     }
 
-    ~raw_memory()
+    constexpr ~raw_memory()
     {
         if (flag_ && data_) [[unlikely]]
         {
@@ -72,21 +96,54 @@ public:
         }
     }
 
-    pointer release() noexcept
+    constexpr pointer release() noexcept
     {
         flag_ = false;
         return data_;
     }
 
-    [[nodiscard]] pointer get() noexcept
+    [[nodiscard]] constexpr pointer get() noexcept
     {
         return data_;
     }
 };
 
+// Contiguous ranges of the same trivially copyable type can be copied with a
+// single memcpy/memmove instead of element by element.
+template <typename InIt, typename OutIt>
+concept bulk_copyable = ::std::contiguous_iterator<InIt> && ::std::contiguous_iterator<OutIt> &&
+                        ::std::is_same_v<::std::iter_value_t<InIt>, ::std::iter_value_t<OutIt>> &&
+                        ::std::is_trivially_copyable_v<::std::iter_value_t<OutIt>>;
+
+// Copies the bytes of [b, e) to out; the ranges may overlap. Not usable in
+// constant evaluation; callers take an element-wise path there.
+template <typename T>
+void move_bytes(const T *b, const T *e, T *out) noexcept
+{
+    if (b != e) [[likely]]
+    {
+        ::std::memmove(static_cast<void *>(out), static_cast<const void *>(b),
+                       static_cast<::std::size_t>(e - b) * sizeof(T));
+    }
+}
+
 template <typename InIt, typename OutIt, typename Alloc>
-void uninitialized_copy(Alloc &a, InIt b1, InIt e1, OutIt b2)
+constexpr void uninitialized_copy(Alloc &a, InIt b1, InIt e1, OutIt b2)
 {
+    if constexpr (bulk_copyable<InIt, OutIt>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            if (b1 != e1) [[likely]]
+            {
+                ::std::memcpy(static_cast<void *>(::std::to_address(b2)),
+                              static_cast<const void *>(::std::to_address(b1)),
+                              static_cast<::std::size_t>(e1 - b1) * sizeof(::std::iter_value_t<OutIt>));
+            }
+            return;
+        }
+    }
+
     construction_guard guard(a, b2);
     for (; b1 != e1; (void)++b1, (void)++b2)
     {
@@ -96,7 +153,7 @@ void uninitialized_copy(Alloc &a, InIt b1, InIt e1, OutIt b2)
 }
 
 template <typename It, typename T, typename Alloc>
-void uninitialized_fill(Alloc &a, It b, It e, const T &value)
+constexpr void uninitialized_fill(Alloc &a, It b, It e, const T &value)
 {
     construction_guard guard(a, b);
     for (; b != e; (void)++b)
@@ -107,7 +164,7 @@ void uninitialized_fill(Alloc &a, It b, It e, const T &value)
 }
 
 template <typename InIt, typename OutIt, typename Alloc>
-void uninitialized_move_if_noexcept(Alloc &a, InIt b1, InIt e1, OutIt b2)
+constexpr void uninitialized_move_if_noexcept(Alloc &a, InIt b1, InIt e1, OutIt b2)
 {
     construction_guard guard(a, b2);
     for (; b1 != e1; (void)++b1, (void)++b2)
@@ -117,8 +174,33 @@ void uninitialized_move_if_noexcept(Alloc &a, InIt b1, InIt e1, OutIt b2)
     guard.release();
 }
 
+// Moves [b1, e1) into the uninitialized storage at b2. Trivially relocatable
+// elements are copied bytewise and the source range must then be treated as raw
+// memory, i.e. deallocated without running destructors.
+template <typename InIt, typename OutIt, typename Alloc>
+constexpr void uninitialized_relocate(Alloc &a, InIt b1, InIt e1, OutIt b2)
+{
+    using value_type = typename ::std::allocator_traits<Alloc>::value_type;
+
+    if constexpr (is_trivially_relocatable_v<value_type>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            if (b1 != e1) [[likely]]
+            {
+                ::std::memcpy(static_cast<void *>(::std::to_address(b2)),
+                              static_cast<const void *>(::std::to_address(b1)),
+                              static_cast<::std::size_t>(e1 - b1) * sizeof(value_type));
+            }
+            return;
+        }
+    }
+
+    uninitialized_move_if_noexcept(a, b1, e1, b2);
+}
+
 template <typename It, typename Alloc>
-void uninitialized_default_construct(Alloc &a, It b, It e)
+constexpr void uninitialized_default_construct(Alloc &a, It b, It e)
 {
     construction_guard guard(a, b);
     for (; b != e; (void)++b)
@@ -128,20 +210,43 @@ void uninitialized_default_construct(Alloc &a, It b, It e)
     guard.release();
 }
 
+// Default-initializes [b, e) in place, bypassing the allocator's construct so
+// trivially default constructible elements are left uninitialized. Constant
+// evaluation needs every element to be constructed, so it value-initializes.
+template <typename It, typename Alloc>
+constexpr void uninitialized_default_init(Alloc &a, It b, It e)
+{
+    using value_type = typename ::std::allocator_traits<Alloc>::value_type;
+
+    if (::std::is_constant_evaluated())
+    {
+        uninitialized_default_construct(a, b, e);
+    }
+    else if constexpr (!::std::is_trivially_default_constructible_v<value_type>)
+    {
+        construction_guard guard(a, b);
+        for (; b != e; (void)++b)
+        {
+            ::new (static_cast<void *>(::std::to_address(b))) value_type;
+        }
+        guard.release();
+    }
+}
+
 template <typename It, typename... Args, typename Alloc>
-void construct_at(Alloc &a, It pos, Args &&...args)
+constexpr void construct_at(Alloc &a, It pos, Args &&...args)
 {
     ::std::allocator_traits<Alloc>::construct(a, ::std::to_address(pos), ::std::forward<Args>(args)...);
 }
 
 template <typename It, typename Alloc>
-void destroy_at(Alloc &a, It pos) noexcept
+constexpr void destroy_at(Alloc &a, It pos) noexcept
 {
     ::std::allocator_traits<Alloc>::destroy(a, ::std::to_address(pos));
 }
 
 template <typename It, typename Alloc>
-void destroy_range(Alloc &a, It b, It e) noexcept
+constexpr void destroy_range(Alloc &a, It b, It e) noexcept
 {
     for (; b != e; (void)++b)
     {
@@ -151,7 +256,95 @@ void destroy_range(Alloc &a, It b, It e) noexcept
 
 } // namespace vector_detail
 
-template <typename T, typename Alloc = ::std::allocator<T>>
+// Growth policies decide the capacity vector allocates when an insertion
+// outgrows the current buffer. next_capacity<T>(cap, required) receives the
+// current capacity and the minimum capacity needed and must return a value of
+// at least required. reserve and resize always allocate exactly what is asked.
+
+// Grows by 1.5x starting from 8 elements.
+struct default_growth
+{
+    template <typename T>
+    [[nodiscard]] static constexpr ::std::size_t next_capacity(::std::size_t cap, ::std::size_t required) noexcept
+    {
+        cap = cap < 8 ? 8 : cap;
+
+        while (cap < required)
+        {
+            cap += cap / 2;
+        }
+
+        return cap;
+    }
+};
+
+// Grows by 2x starting from 8 elements, trading memory for fewer
+// reallocations in append-heavy code.
+struct doubling_growth
+{
+    template <typename T>
+    [[nodiscard]] static constexpr ::std::size_t next_capacity(::std::size_t cap, ::std::size_t required) noexcept
+    {
+        cap = cap < 8 ? 8 : cap;
+
+        while (cap < required)
+        {
+            cap *= 2;
+        }
+
+        return cap;
+    }
+};
+
+// Allocates exactly what is required, for memory-tight containers that are
+// rarely appended to.
+struct exact_growth
+{
+    template <typename T>
+    [[nodiscard]] static constexpr ::std::size_t next_capacity(::std::size_t, ::std::size_t required) noexcept
+    {
+        return required;
+    }
+};
+
+// Grows like default_growth, then rounds the buffer up to a whole number of
+// pages so huge buffers never leave a partially used page at the end.
+template <::std::size_t PageSize = 4096>
+struct page_growth
+{
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two.");
+
+    template <typename T>
+    [[nodiscard]] static constexpr ::std::size_t next_capacity(::std::size_t cap, ::std::size_t required) noexcept
+    {
+        auto bytes = default_growth::next_capacity<T>(cap, required) * sizeof(T);
+        bytes = (bytes + PageSize - 1) & ~(PageSize - 1);
+        return bytes / sizeof(T);
+    }
+};
+
+// Grows like default_growth, then rounds the buffer up to the next
+// jemalloc-style size class (four classes per power of two) so the slack the
+// allocator would waste anyway becomes usable capacity.
+struct size_class_growth
+{
+    template <typename T>
+    [[nodiscard]] static constexpr ::std::size_t next_capacity(::std::size_t cap, ::std::size_t required) noexcept
+    {
+        auto bytes = default_growth::next_capacity<T>(cap, required) * sizeof(T);
+
+        ::std::size_t spacing = 16;
+        if (bytes > 64)
+        {
+            spacing = ::std::size_t(1) << (::std::bit_width(bytes - 1) - 3);
+        }
+
+        bytes = (bytes + spacing - 1) & ~(spacing - 1);
+        return bytes / sizeof(T);
+    }
+};
+
+template <typename T, typename Alloc = ::std::allocator<T>, typename GrowthPolicy = default_growth>
 class vector
 {
     using atraits_t = ::std::allocator_traits<Alloc>;
@@ -170,59 +363,59 @@ public:
     using reverse_iterator = ::std::reverse_iterator<iterator>;
     using const_reverse_iterator = ::std::reverse_iterator<const_iterator>;
 
-    explicit vector(const Alloc &alloc) noexcept : alloc_(alloc)
+    constexpr explicit vector(const Alloc &alloc, vector_detail::call_site site = {}) noexcept
+        : alloc_(alloc), probe_(site)
     {
     }
 
-    vector() noexcept(noexcept(Alloc())) : vector(Alloc())
+    constexpr vector(vector_detail::call_site site = {}) noexcept(noexcept(Alloc())) : vector(Alloc(), site)
     {
     }
 
-    template <class InputIt>
-    vector(InputIt first, InputIt last, const Alloc &alloc = Alloc()) : alloc_(alloc)
+    template <::std::input_iterator InputIt>
+    constexpr vector(InputIt first, InputIt last, const Alloc &alloc = Alloc(), vector_detail::call_site site = {})
+        : vector(alloc, site)
     {
-        if constexpr (::std::forward_iterator<InputIt>)
-        {
-            auto count = ::std::distance(first, last);
-            reserve(count);
-            vector_detail::uninitialized_copy(alloc_, first, last, data_, data_ + count);
-            size_ = count;
-        }
-        else
-        {
-            for (; first != last; (void)++first)
-            {
-                emplace_back(*first);
-            }
-        }
+        assign(first, last);
+    }
+
+    constexpr vector(size_type count, for_overwrite_t, const Alloc &alloc = Alloc(),
+                     vector_detail::call_site site = {})
+        : vector(alloc, site)
+    {
+        reserve(count);
+        vector_detail::uninitialized_default_init(alloc_, data_, data_ + count);
+        size_ = count;
     }
 
-    vector(::std::initializer_list<value_type> init, const Alloc &alloc = Alloc())
-        : vector(init.begin(), init.end(), alloc)
+    constexpr vector(::std::initializer_list<value_type> init, const Alloc &alloc = Alloc(),
+                     vector_detail::call_site site = {})
+        : vector(init.begin(), init.end(), alloc, site)
     {
     }
 
-    vector(const vector &other) : alloc_(atraits_t::select_on_container_copy_construction(other.alloc_))
+    constexpr vector(const vector &other, vector_detail::call_site site = {})
+        : vector(atraits_t::select_on_container_copy_construction(other.alloc_), site)
     {
         assign(other.cbegin(), other.cend());
     }
 
-    vector(vector &&other) noexcept
+    constexpr vector(vector &&other, vector_detail::call_site site = {}) noexcept
         : data_(::std::exchange(other.data_, nullptr)), size_(::std::exchange(other.size_, 0)),
-          cap_(::std::exchange(other.cap_, 0)), alloc_(::std::move(other.alloc_))
+          cap_(::std::exchange(other.cap_, 0)), alloc_(::std::move(other.alloc_)), probe_(site)
     {
     }
 
-    explicit vector(size_type count, const value_type &value = value_type(), const Alloc &alloc = Alloc())
-        : alloc_(alloc)
+    constexpr explicit vector(size_type count, const value_type &value = value_type(),
+                              const Alloc &alloc = Alloc(), vector_detail::call_site site = {})
+        : vector(alloc, site)
     {
-        reserve(count);
-        vector_detail::uninitialized_fill(alloc_, data_, data_ + count, value);
-        size_ = count;
+        assign(count, value);
     }
 
-    ~vector()
+    constexpr ~vector()
     {
+        probe_.on_destroy((cap_ - size_) * sizeof(value_type));
         clear();
         if (data_) [[likely]]
         {
@@ -230,58 +423,99 @@ public:
         }
     }
 
-    void assign(size_type count, const T &value)
+    constexpr void assign(size_type count, const T &value)
     {
-        reserve(count);
-
-        for (auto i = size_type(0); i != (count < size_) ? count : size_; ++i)
+        if (cap_ < count)
         {
-            data_[i] = value;
+            vector_detail::raw_memory raw(alloc_, count);
+            auto raw_p = raw.get();
+            vector_detail::uninitialized_fill(alloc_, raw_p, raw_p + count, value);
+            note_allocation(0, count);
+            destroy_and_deallocate();
+            data_ = raw.release();
+            size_ = count;
+            cap_ = count;
+            return;
         }
 
+        ::std::fill(data_, data_ + (count < size_ ? count : size_), value);
+
         if (count < size_)
         {
-            vector_detail::destroy_range(alloc_, data_ + count, data_ + size_);
+            truncate_to(count);
         }
-
-        if (count > size_)
+        else
         {
-            vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + size_ + count, value);
+            vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + count, value);
+            size_ = count;
         }
-
-        size_ = count;
     }
 
-    template <typename InputIt>
-    void assign(InputIt first, InputIt last)
+    template <::std::input_iterator InputIt>
+    constexpr void assign(InputIt first, InputIt last)
     {
-        auto count = last - first;
-        reserve(count);
-
-        for (auto i = size_type(0); i != (count < size_) ? count : size_; ++i, (void)++first)
+        if constexpr (::std::forward_iterator<InputIt>)
         {
-            data_[i] = *first;
-        }
+            auto count = static_cast<size_type>(::std::distance(first, last));
+            if (cap_ < count)
+            {
+                vector_detail::raw_memory raw(alloc_, count);
+                auto raw_p = raw.get();
+                vector_detail::uninitialized_copy(alloc_, first, last, raw_p);
+                note_allocation(0, count);
+                destroy_and_deallocate();
+                data_ = raw.release();
+                size_ = count;
+                cap_ = count;
+                return;
+            }
 
-        if (count < size_)
-        {
-            vector_detail::destroy_range(alloc_, data_ + count, data_ + size_);
-        }
+            // Constant evaluation cannot copy bytes into storage where no
+            // object has been constructed yet, nor order pointers into
+            // unrelated objects.
+            if constexpr (vector_detail::bulk_copyable<InputIt, iterator>)
+            {
+                if (!::std::is_constant_evaluated())
+                {
+                    vector_detail::move_bytes(::std::to_address(first), ::std::to_address(last),
+                                              ::std::to_address(data_));
+                    size_ = count;
+                    return;
+                }
+            }
+
+            auto common = count < size_ ? count : size_;
+            for (auto i = size_type(0); i != common; ++i, (void)++first)
+            {
+                data_[i] = *first;
+            }
 
-        if (count > size_)
+            if (count < size_)
+            {
+                truncate_to(count);
+            }
+            else
+            {
+                vector_detail::uninitialized_copy(alloc_, first, last, data_ + size_);
+                size_ = count;
+            }
+        }
+        else
         {
-            vector_detail::uninitialized_copy(alloc_, first, last, data_ + size_, data_ + size_ + count);
+            clear();
+            for (; first != last; (void)++first)
+            {
+                emplace_back(*first);
+            }
         }
-
-        size_ = count;
     }
 
-    void assign(::std::initializer_list<T> list)
+    constexpr void assign(::std::initializer_list<T> list)
     {
-        assign(list.cbegin(), list.cend());
+        assign(list.begin(), list.end());
     }
 
-    vector &operator=(const vector &other)
+    constexpr vector &operator=(const vector &other)
     {
         if (::std::addressof(other) == this) [[unlikely]]
         {
@@ -302,7 +536,7 @@ public:
         return *this;
     }
 
-    vector &operator=(vector &&other)
+    constexpr vector &operator=(vector &&other)
     {
         if (::std::addressof(other) == this) [[unlikely]]
         {
@@ -311,72 +545,66 @@ public:
 
         if constexpr (atraits_t::propagate_on_container_move_assignment::value)
         {
-            destroy_and_deallocate();
-            data_ = ::std::exchange(other.data_, nullptr);
-            size_ = ::std::exchange(other.size_, 0);
-            cap_ = ::std::exchange(other.cap_, 0);
+            take_storage(other);
             alloc_ = ::std::move(other.alloc_);
         }
         else
         {
-            assign(::std::make_move_iterator(other.begin()), ::std::make_move_iterator(other.end()));
+            // Allocators that do not propagate, such as polymorphic_allocator,
+            // can still hand over the buffer when they share a resource.
+            if (alloc_ == other.alloc_)
+            {
+                take_storage(other);
+            }
+            else
+            {
+                assign(::std::make_move_iterator(other.begin()), ::std::make_move_iterator(other.end()));
+            }
         }
 
         return *this;
     }
 
-    vector &operator=(::std::initializer_list<value_type> list)
+    constexpr vector &operator=(::std::initializer_list<value_type> list)
     {
-        assign(list.cbegin(), list.cend());
+        assign(list.begin(), list.end());
         return *this;
     }
 
-    [[nodiscard]] reference operator[](size_type pos)
+    [[nodiscard]] constexpr reference operator[](size_type pos)
     {
-        if (size_ <= pos) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(pos < size_);
 
         return *(data_ + pos);
     }
 
-    [[nodiscard]] const_reference operator[](size_type pos) const
+    [[nodiscard]] constexpr const_reference operator[](size_type pos) const
     {
-        if (size_ <= pos) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(pos < size_);
 
         return *(data_ + pos);
     }
 
-    [[nodiscard]] reference index_unchecked(size_type pos)
+    [[nodiscard]] constexpr reference index_unchecked(size_type pos)
     {
         return *(data_ + pos);
     }
 
-    [[nodiscard]] const_reference index_unchecked(size_type pos) const
+    [[nodiscard]] constexpr const_reference index_unchecked(size_type pos) const
     {
         return *(data_ + pos);
     }
 
     [[nodiscard]] constexpr reference front() noexcept
     {
-        if (empty()) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(!empty());
 
         return *data_;
     }
 
     [[nodiscard]] constexpr const_reference front() const noexcept
     {
-        if (empty()) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(!empty());
 
         return *data_;
     }
@@ -393,20 +621,14 @@ public:
 
     [[nodiscard]] constexpr reference back() noexcept
     {
-        if (empty()) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(!empty());
 
         return *(data_ + size_ - 1);
     }
 
     [[nodiscard]] constexpr const_reference back() const noexcept
     {
-        if (empty()) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(!empty());
 
         return *(data_ + size_ - 1);
     }
@@ -511,12 +733,12 @@ public:
         return cap_;
     }
 
-    [[nodiscard]] allocator_type get_allocator() const noexcept
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept
     {
         return alloc_;
     }
 
-    void reserve(size_type required_cap)
+    constexpr void reserve(size_type required_cap)
     {
         if (required_cap <= cap_) [[unlikely]]
         {
@@ -526,7 +748,7 @@ public:
         reallocate(required_cap);
     }
 
-    void shrink_to_fit()
+    constexpr void shrink_to_fit()
     {
         if (size_ == cap_) [[unlikely]]
         {
@@ -544,83 +766,92 @@ public:
         reallocate(size_);
     }
 
-    void clear() noexcept
+    constexpr void clear() noexcept
     {
         vector_detail::destroy_range(alloc_, begin(), end());
         size_ = 0;
     }
 
-    iterator insert(const_iterator pos, const value_type &value)
+    constexpr iterator insert(const_iterator pos, const value_type &value)
     {
         return emplace_impl(index_of(pos), value);
     }
 
-    iterator insert(const_iterator pos, T &&value)
+    constexpr iterator insert(const_iterator pos, T &&value)
     {
         return emplace_impl(index_of(pos), ::std::move(value));
     }
 
-    iterator insert(const_iterator pos, size_type count, const T &value)
+    constexpr iterator insert(const_iterator pos, size_type count, const T &value)
     {
         return insert_impl(index_of(pos), count, value);
     }
 
-    template <typename InputIt>
-    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    template <::std::input_iterator InputIt>
+    constexpr iterator insert(const_iterator pos, InputIt first, InputIt last)
     {
+        auto pos_i = index_of(pos);
+        if constexpr (::std::forward_iterator<InputIt>)
+        {
+            return insert_impl(pos_i, first, last);
+        }
+        else
+        {
+            for (auto i = pos_i; first != last; (void)++first, (void)++i)
+            {
+                emplace_impl(i, *first);
+            }
 
-        return insert_impl(index_of(pos), first, last);
+            return data_ + pos_i;
+        }
     }
 
-    iterator insert(const_iterator pos, ::std::initializer_list<T> list)
+    constexpr iterator insert(const_iterator pos, ::std::initializer_list<T> list)
     {
         return insert_impl(index_of(pos), list.begin(), list.end());
     }
 
     template <typename... Args>
-    iterator emplace(const_iterator pos, Args &&...args)
+    constexpr iterator emplace(const_iterator pos, Args &&...args)
     {
         return emplace_impl(index_of(pos), ::std::forward<Args>(args)...);
     }
 
-    iterator erase(const_iterator pos)
+    constexpr iterator erase(const_iterator pos)
     {
         return erase_impl(pos, pos + 1);
     }
 
-    iterator erase(const_iterator first, const_iterator last)
+    constexpr iterator erase(const_iterator first, const_iterator last)
     {
         return erase_impl(first, last);
     }
 
-    void push_back(const T &value)
+    constexpr void push_back(const T &value)
     {
         (void)emplace_back_impl(value);
     }
 
-    void push_back(T &&value)
+    constexpr void push_back(T &&value)
     {
         (void)emplace_back_impl(::std::move(value));
     }
 
     template <typename... Args>
-    reference emplace_back(Args &&...args)
+    constexpr reference emplace_back(Args &&...args)
     {
         return *emplace_back_impl(::std::forward<Args>(args)...);
     }
 
-    void pop_back()
+    constexpr void pop_back()
     {
-        if (empty()) [[unlikely]]
-        {
-            terminate();
-        }
+        check_bounds(!empty());
 
         vector_detail::destroy_at(alloc_, data_ + size_ - 1);
         --size_;
     }
 
-    void resize(size_type new_size)
+    constexpr void resize(size_type new_size)
     {
         if (new_size < size_)
         {
@@ -633,7 +864,7 @@ public:
         }
     }
 
-    void resize(size_type new_size, const value_type &value)
+    constexpr void resize(size_type new_size, const value_type &value)
     {
         if (new_size < size_)
         {
@@ -646,8 +877,34 @@ public:
         }
     }
 
-    void swap(vector &other) noexcept(noexcept(::std::is_nothrow_swappable_v<pointer> &&
-                                               ::std::is_nothrow_swappable_v<Alloc>))
+    // Like resize, but new elements are default-initialized, so a buffer that
+    // is about to be filled by read(), memcpy or a kernel is not zeroed first.
+    constexpr void resize_for_overwrite(size_type new_size)
+    {
+        if (new_size < size_)
+        {
+            truncate_to(new_size);
+        }
+
+        if (new_size > size_)
+        {
+            (void)append_for_overwrite(new_size - size_);
+        }
+    }
+
+    // Appends count default-initialized elements and returns a pointer to the
+    // first of them.
+    constexpr pointer append_for_overwrite(size_type count)
+    {
+        reserve(size_ + count);
+        auto tail = data_ + size_;
+        vector_detail::uninitialized_default_init(alloc_, tail, tail + count);
+        size_ += count;
+        return tail;
+    }
+
+    constexpr void swap(vector &other) noexcept(noexcept(::std::is_nothrow_swappable_v<pointer> &&
+                                                         ::std::is_nothrow_swappable_v<Alloc>))
     {
         using ::std::swap;
 
@@ -662,19 +919,16 @@ public:
     }
 
 private:
-    [[nodiscard]] size_type next_capacity(size_type required)
-    {
-        size_type cap = cap_ < 8 ? 8 : cap_;
+    static constexpr bool can_resize_in_place =
+        vector_detail::has_try_expand<Alloc> ||
+        (vector_detail::has_reallocate<Alloc> && is_trivially_relocatable_v<value_type>);
 
-        while (cap < required)
-        {
-            cap += cap / 2;
-        }
-
-        return cap;
+    [[nodiscard]] constexpr size_type next_capacity(size_type required)
+    {
+        return static_cast<size_type>(GrowthPolicy::template next_capacity<value_type>(cap_, required));
     }
 
-    [[nodiscard]] size_type index_of(const_iterator pos) const
+    [[nodiscard]] constexpr size_type index_of(const_iterator pos) const
     {
         if (data_ == nullptr)
         {
@@ -695,7 +949,7 @@ private:
         return idx;
     }
 
-    iterator insert_impl(size_type pos_i, size_type count, const value_type &value)
+    constexpr iterator insert_impl(size_type pos_i, size_type count, const value_type &value)
     {
         if (cap_ < size_ + count)
         {
@@ -703,15 +957,32 @@ private:
             vector_detail::raw_memory raw(alloc_, new_cap);
             auto raw_p = raw.get();
             vector_detail::uninitialized_fill(alloc_, raw_p + pos_i, raw_p + pos_i + count, value);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_, data_ + pos_i, raw_p);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
-            destroy_and_deallocate();
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
+            note_allocation(size_, new_cap);
+            deallocate_relocated();
             data_ = raw.release();
             size_ += count;
             cap_ = new_cap;
         }
         else
         {
+            // Constant evaluation cannot shift into storage where no object
+            // has been constructed yet.
+            if constexpr (::std::is_trivially_copyable_v<value_type>)
+            {
+                if (!::std::is_constant_evaluated())
+                {
+                    // value may refer to an element that is about to be shifted.
+                    auto copy = value;
+                    auto pos_p = ::std::to_address(data_ + pos_i);
+                    vector_detail::move_bytes(pos_p, ::std::to_address(data_ + size_), pos_p + count);
+                    vector_detail::uninitialized_fill(alloc_, data_ + pos_i, data_ + pos_i + count, copy);
+                    size_ += count;
+                    return data_ + pos_i;
+                }
+            }
+
             auto old_end = data_ + size_;
             vector_detail::uninitialized_fill(alloc_, old_end, old_end + count, value);
             size_ += count;
@@ -722,26 +993,40 @@ private:
     }
 
     template <typename It>
-    iterator insert_impl(size_type pos_i, It b, It e)
+    constexpr iterator insert_impl(size_type pos_i, It b, It e)
     {
-        auto count = ::std::distance(b, e);
+        auto count = static_cast<size_type>(::std::distance(b, e));
         if (cap_ < size_ + count)
         {
             auto new_cap = next_capacity(size_ + count);
             vector_detail::raw_memory raw(alloc_, new_cap);
             auto raw_p = raw.get();
-            vector_detail::uninitialized_copy(alloc_, raw_p + pos_i, raw_p + pos_i + count, b);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_, data_ + pos_i, raw_p);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
-            destroy_and_deallocate();
+            vector_detail::uninitialized_copy(alloc_, b, e, raw_p + pos_i);
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + count);
+            note_allocation(size_, new_cap);
+            deallocate_relocated();
             data_ = raw.release();
             size_ += count;
             cap_ = new_cap;
         }
         else
         {
+            if constexpr (::std::is_trivially_copyable_v<value_type> &&
+                          ::std::is_nothrow_constructible_v<value_type, ::std::iter_reference_t<It>>)
+            {
+                if (!::std::is_constant_evaluated())
+                {
+                    auto pos_p = ::std::to_address(data_ + pos_i);
+                    vector_detail::move_bytes(pos_p, ::std::to_address(data_ + size_), pos_p + count);
+                    vector_detail::uninitialized_copy(alloc_, b, e, data_ + pos_i);
+                    size_ += count;
+                    return data_ + pos_i;
+                }
+            }
+
             auto old_end = data_ + size_;
-            vector_detail::uninitialized_fill(alloc_, old_end, old_end + count, b);
+            vector_detail::uninitialized_copy(alloc_, b, e, old_end);
             size_ += count;
             ::std::rotate(data_ + pos_i, old_end, data_ + size_);
         }
@@ -750,7 +1035,7 @@ private:
     }
 
     template <typename... Args>
-    iterator emplace_impl(size_type pos_i, Args &&...args)
+    constexpr iterator emplace_impl(size_type pos_i, Args &&...args)
     {
         if (cap_ < size_ + 1)
         {
@@ -758,15 +1043,30 @@ private:
             vector_detail::raw_memory raw(alloc_, new_cap);
             auto raw_p = raw.get();
             vector_detail::construct_at(alloc_, raw_p + pos_i, ::std::forward<Args>(args)...);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_, data_ + pos_i, raw_p);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + 1);
-            destroy_and_deallocate();
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + pos_i, raw_p);
+            vector_detail::uninitialized_relocate(alloc_, data_ + pos_i, data_ + size_, raw_p + pos_i + 1);
+            note_allocation(size_, new_cap);
+            deallocate_relocated();
             data_ = raw.release();
             ++size_;
             cap_ = new_cap;
         }
         else
         {
+            if constexpr (::std::is_trivially_copyable_v<value_type>)
+            {
+                if (!::std::is_constant_evaluated())
+                {
+                    // args may refer to an element that is about to be shifted.
+                    value_type tmp(::std::forward<Args>(args)...);
+                    auto pos_p = ::std::to_address(data_ + pos_i);
+                    vector_detail::move_bytes(pos_p, ::std::to_address(data_ + size_), pos_p + 1);
+                    vector_detail::construct_at(alloc_, data_ + pos_i, tmp);
+                    ++size_;
+                    return data_ + pos_i;
+                }
+            }
+
             auto old_end = data_ + size_;
             vector_detail::construct_at(alloc_, old_end, ::std::forward<Args>(args)...);
             ++size_;
@@ -777,16 +1077,30 @@ private:
     }
 
     template <typename... Args>
-    iterator emplace_back_impl(Args &&...args)
+    constexpr iterator emplace_back_impl(Args &&...args)
     {
+        if constexpr (can_resize_in_place)
+        {
+            if (cap_ < size_ + 1 && data_)
+            {
+                // args may refer into the buffer that reallocate is about to move.
+                value_type tmp(::std::forward<Args>(args)...);
+                reallocate(next_capacity(size_ + 1));
+                vector_detail::construct_at(alloc_, data_ + size_, ::std::move(tmp));
+                ++size_;
+                return data_ + size_ - 1;
+            }
+        }
+
         if (cap_ < size_ + 1)
         {
             auto new_cap = next_capacity(size_ + 1);
             vector_detail::raw_memory raw(alloc_, new_cap);
             auto raw_p = raw.get();
             vector_detail::construct_at(alloc_, raw_p + size_, ::std::forward<Args>(args)...);
-            vector_detail::uninitialized_move_if_noexcept(alloc_, data_, data_ + size_, raw_p);
-            destroy_and_deallocate();
+            vector_detail::uninitialized_relocate(alloc_, data_, data_ + size_, raw_p);
+            note_allocation(size_, new_cap);
+            deallocate_relocated();
             data_ = raw.release();
             ++size_;
             cap_ = new_cap;
@@ -797,10 +1111,10 @@ private:
             ++size_;
         }
 
-        return end();
+        return data_ + size_ - 1;
     }
 
-    iterator erase_impl(const_iterator first, const_iterator last)
+    constexpr iterator erase_impl(const_iterator first, const_iterator last)
     {
         auto erase_count = last - first;
         auto dst = const_cast<iterator>(first);
@@ -819,7 +1133,7 @@ private:
         return const_cast<iterator>(first);
     }
 
-    void destroy_and_deallocate()
+    constexpr void destroy_and_deallocate()
     {
         if (data_) [[likely]]
         {
@@ -828,32 +1142,88 @@ private:
         }
     }
 
-    void reallocate(size_type new_cap)
+    // Reports a new buffer of new_cap elements to the telemetry probe before
+    // it replaces data_; moved elements were relocated out of the old one.
+    constexpr void note_allocation(size_type moved, size_type new_cap) noexcept
+    {
+        probe_.on_allocate(data_ != nullptr, moved * sizeof(value_type), new_cap * sizeof(value_type));
+    }
+
+    constexpr void take_storage(vector &other) noexcept
+    {
+        destroy_and_deallocate();
+        data_ = ::std::exchange(other.data_, nullptr);
+        size_ = ::std::exchange(other.size_, 0);
+        cap_ = ::std::exchange(other.cap_, 0);
+    }
+
+    // Frees the buffer after its elements were moved out by
+    // uninitialized_relocate. Trivially relocated elements are already owned by
+    // the new buffer, so their destructors must not run here.
+    constexpr void deallocate_relocated()
+    {
+        if constexpr (is_trivially_relocatable_v<value_type>)
+        {
+            if (data_) [[likely]]
+            {
+                alloc_.deallocate(data_, cap_);
+            }
+        }
+        else
+        {
+            destroy_and_deallocate();
+        }
+    }
+
+    constexpr void reallocate(size_type new_cap)
     {
+        if constexpr (vector_detail::has_try_expand<Alloc>)
+        {
+            if (data_ && cap_ < new_cap && alloc_.try_expand(data_, cap_, new_cap))
+            {
+                note_allocation(0, new_cap);
+                cap_ = new_cap;
+                return;
+            }
+        }
+
+        if constexpr (vector_detail::has_reallocate<Alloc> && is_trivially_relocatable_v<value_type>)
+        {
+            if (data_)
+            {
+                // The pages are remapped, not copied.
+                note_allocation(0, new_cap);
+                data_ = alloc_.reallocate(data_, cap_, new_cap);
+                cap_ = new_cap;
+                return;
+            }
+        }
+
         vector_detail::raw_memory raw(alloc_, new_cap);
         auto raw_p = raw.get();
-        vector_detail::uninitialized_move_if_noexcept(alloc_, begin(), end(), raw_p);
+        vector_detail::uninitialized_relocate(alloc_, begin(), end(), raw_p);
+        note_allocation(size_, new_cap);
 
-        destroy_and_deallocate();
+        deallocate_relocated();
 
         data_ = raw.release();
         cap_ = new_cap;
     }
 
-    void truncate_to(size_type new_size) noexcept
+    constexpr void truncate_to(size_type new_size) noexcept
     {
         vector_detail::destroy_range(alloc_, data_ + new_size, data_ + size_);
         size_ = new_size;
     }
 
-    void append_default_n(size_type count)
+    constexpr void append_default_n(size_type count)
     {
         reserve(size_ + count);
-        vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + size_ + count);
+        vector_detail::uninitialized_default_construct(alloc_, data_ + size_, data_ + size_ + count);
         size_ += count;
     }
 
-    void append_fill_n(size_type count, const value_type &value)
+    constexpr void append_fill_n(size_type count, const value_type &value)
     {
         reserve(size_ + count);
         vector_detail::uninitialized_fill(alloc_, data_ + size_, data_ + size_ + count, value);
@@ -867,25 +1237,36 @@ private:
     size_type cap_{};
 
     [[no_unique_address]] Alloc alloc_{};
+
+    [[no_unique_address]] vector_detail::telemetry_probe probe_;
 };
 
-template <typename T, typename Alloc>
-void swap(vector<T, Alloc> &lhs, vector<T, Alloc> &rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename T, typename Alloc, typename GrowthPolicy>
+constexpr void swap(vector<T, Alloc, GrowthPolicy> &lhs,
+                    vector<T, Alloc, GrowthPolicy> &rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
-template <typename T, typename Alloc>
-bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename GrowthPolicy>
+constexpr bool operator==(const vector<T, Alloc, GrowthPolicy> &lhs, const vector<T, Alloc, GrowthPolicy> &rhs)
 {
     if (lhs.size() != rhs.size())
     {
         return false;
     }
 
+    if constexpr (::std::is_arithmetic_v<T>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            return simd_detail::equal(::std::to_address(lhs.data()), ::std::to_address(rhs.data()), lhs.size());
+        }
+    }
+
     for (decltype(lhs.size()) i = 0; i != lhs.size(); ++i)
     {
-        if (lhs[i] != rhs[i])
+        if (lhs.index_unchecked(i) != rhs.index_unchecked(i))
         {
             return false;
         }
@@ -894,13 +1275,22 @@ bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs)
     return true;
 }
 
-template <typename T, class Alloc>
-constexpr auto operator<=>(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs)
+template <typename T, typename Alloc, typename GrowthPolicy>
+constexpr auto operator<=>(const vector<T, Alloc, GrowthPolicy> &lhs, const vector<T, Alloc, GrowthPolicy> &rhs)
 {
+    if constexpr (::std::is_integral_v<T>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            return simd_detail::compare(::std::to_address(lhs.data()), lhs.size(), ::std::to_address(rhs.data()),
+                                        rhs.size());
+        }
+    }
+
     auto min_size = (lhs.size() < rhs.size()) ? lhs.size() : rhs.size();
     for (decltype(lhs.size()) i = 0; i != min_size; ++i)
     {
-        auto cmp = lhs[i] <=> rhs[i];
+        auto cmp = lhs.index_unchecked(i) <=> rhs.index_unchecked(i);
         if (cmp != 0)
         {
             return cmp;
@@ -910,10 +1300,21 @@ constexpr auto operator<=>(const vector<T, Alloc> &lhs, const vector<T, Alloc> &
     return lhs.size() <=> rhs.size();
 }
 
-template <typename T, typename Alloc, typename U = T>
-constexpr typename vector<T, Alloc>::size_type erase(vector<T, Alloc> &c, const U &value)
+template <typename T, typename Alloc, typename GrowthPolicy, typename U = T>
+constexpr typename vector<T, Alloc, GrowthPolicy>::size_type erase(vector<T, Alloc, GrowthPolicy> &c, const U &value)
 {
     auto old_size = c.size();
+
+    if constexpr (::std::is_arithmetic_v<T> && ::std::is_same_v<T, U>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            auto kept = simd_detail::remove(::std::to_address(c.data()), old_size, value);
+            c.erase(c.begin() + kept, c.end());
+            return old_size - kept;
+        }
+    }
+
     auto first = c.begin();
     auto last = c.end();
     first = ::std::find(first, last, value);
@@ -938,10 +1339,21 @@ constexpr typename vector<T, Alloc>::size_type erase(vector<T, Alloc> &c, const
     return old_size - c.size();
 }
 
-template <typename T, typename Alloc, typename Pred>
-constexpr typename vector<T, Alloc>::size_type erase_if(vector<T, Alloc> &c, Pred pred)
+template <typename T, typename Alloc, typename GrowthPolicy, typename Pred>
+constexpr typename vector<T, Alloc, GrowthPolicy>::size_type erase_if(vector<T, Alloc, GrowthPolicy> &c, Pred pred)
 {
     auto old_size = c.size();
+
+    if constexpr (::std::is_arithmetic_v<T>)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            auto kept = simd_detail::remove_if(::std::to_address(c.data()), old_size, pred);
+            c.erase(c.begin() + kept, c.end());
+            return old_size - kept;
+        }
+    }
+
     auto first = c.begin();
     auto last = c.end();
     first = ::std::find_if(first, last, pred);
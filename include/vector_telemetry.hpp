@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+
+#ifdef EVQOVV_UTILS_VECTOR_TELEMETRY
+#include "mutex.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <source_location>
+#include <type_traits>
+#endif
+
+namespace evqovv
+{
+namespace utils
+{
+// Per-call-site growth statistics of vector, collected when
+// EVQOVV_UTILS_VECTOR_TELEMETRY is defined. A vector is attributed to the
+// source location of its constructor call. Wasted capacity (cap_ - size_) is
+// sampled when a vector is destroyed.
+struct vector_site_stats
+{
+    const char *file;
+    unsigned line;
+    unsigned column;
+    const char *function;
+    ::std::size_t vectors;
+    ::std::size_t allocations;
+    ::std::size_t reallocations;
+    ::std::size_t bytes_moved;
+    ::std::size_t peak_capacity_bytes;
+    ::std::size_t destroyed;
+    ::std::size_t wasted_bytes;
+};
+
+namespace vector_detail
+{
+#ifdef EVQOVV_UTILS_VECTOR_TELEMETRY
+// Captures the location of the expression that constructs a vector: as a
+// defaulted constructor parameter, current() is evaluated at the caller.
+struct call_site
+{
+    ::std::source_location location;
+
+    constexpr call_site(::std::source_location loc = ::std::source_location::current()) noexcept : location(loc)
+    {
+    }
+};
+
+struct site_record
+{
+    ::std::source_location location;
+    ::std::atomic<::std::size_t> vectors{0};
+    ::std::atomic<::std::size_t> allocations{0};
+    ::std::atomic<::std::size_t> reallocations{0};
+    ::std::atomic<::std::size_t> bytes_moved{0};
+    ::std::atomic<::std::size_t> peak_capacity_bytes{0};
+    ::std::atomic<::std::size_t> destroyed{0};
+    ::std::atomic<::std::size_t> wasted_bytes{0};
+    site_record *next{};
+};
+
+class site_registry
+{
+public:
+    // Never destroyed: vectors with static storage duration report to it
+    // during static destruction.
+    [[nodiscard]] static site_registry &instance()
+    {
+        static auto registry = new site_registry;
+        return *registry;
+    }
+
+    // The first construction at a call site takes the lock and compares names;
+    // later ones find the record through a lock-free table keyed on the
+    // location's string addresses, which are fixed per call site.
+    [[nodiscard]] site_record *find_or_add(const ::std::source_location &loc)
+    {
+        auto start = hash(loc);
+        for (::std::size_t i = 0; i != alias_count; ++i)
+        {
+            auto a = aliases_[(start + i) & (alias_count - 1)].load(::std::memory_order_acquire);
+            if (!a)
+            {
+                break;
+            }
+
+            if (same_site(a->location, loc))
+            {
+                return a->record;
+            }
+        }
+
+        ::std::lock_guard<mutex> guard(lock_);
+        auto r = find_or_add_locked(loc);
+
+        // Inserts only happen under the lock, so an empty bucket stays empty
+        // until the store below. If the table is full, the site keeps taking
+        // the slow path.
+        for (::std::size_t i = 0; i != alias_count; ++i)
+        {
+            auto &bucket = aliases_[(start + i) & (alias_count - 1)];
+            auto a = bucket.load(::std::memory_order_relaxed);
+            if (!a)
+            {
+                bucket.store(new site_alias{loc, r}, ::std::memory_order_release);
+                break;
+            }
+
+            if (same_site(a->location, loc))
+            {
+                break;
+            }
+        }
+
+        return r;
+    }
+
+    template <typename F>
+    void for_each(F &f)
+    {
+        ::std::lock_guard<mutex> guard(lock_);
+        for (auto r = head_; r; r = r->next)
+        {
+            f(vector_site_stats{r->location.file_name(), r->location.line(), r->location.column(),
+                                r->location.function_name(), r->vectors.load(::std::memory_order_relaxed),
+                                r->allocations.load(::std::memory_order_relaxed),
+                                r->reallocations.load(::std::memory_order_relaxed),
+                                r->bytes_moved.load(::std::memory_order_relaxed),
+                                r->peak_capacity_bytes.load(::std::memory_order_relaxed),
+                                r->destroyed.load(::std::memory_order_relaxed),
+                                r->wasted_bytes.load(::std::memory_order_relaxed)});
+        }
+    }
+
+private:
+    // Maps one spelling of a call site's location to its record; the same site
+    // can have several when its strings are not merged across translation
+    // units.
+    struct site_alias
+    {
+        ::std::source_location location;
+        site_record *record;
+    };
+
+    static constexpr unsigned alias_bits = 10;
+    static constexpr ::std::size_t alias_count = ::std::size_t(1) << alias_bits;
+
+    [[nodiscard]] static bool same_site(const ::std::source_location &a, const ::std::source_location &b) noexcept
+    {
+        return a.file_name() == b.file_name() && a.function_name() == b.function_name() && a.line() == b.line() &&
+               a.column() == b.column();
+    }
+
+    [[nodiscard]] static ::std::size_t hash(const ::std::source_location &loc) noexcept
+    {
+        auto h = static_cast<::std::uint64_t>(reinterpret_cast<::std::uintptr_t>(loc.file_name()));
+        h = h * 31 + reinterpret_cast<::std::uintptr_t>(loc.function_name());
+        h = h * 31 + (static_cast<::std::uint64_t>(loc.line()) << 16 | loc.column());
+        return static_cast<::std::size_t>((h * 0x9E3779B97F4A7C15ull) >> (64 - alias_bits));
+    }
+
+    [[nodiscard]] site_record *find_or_add_locked(const ::std::source_location &loc)
+    {
+        for (auto r = head_; r; r = r->next)
+        {
+            if (r->location.line() == loc.line() && r->location.column() == loc.column() &&
+                ::std::strcmp(r->location.file_name(), loc.file_name()) == 0 &&
+                ::std::strcmp(r->location.function_name(), loc.function_name()) == 0)
+            {
+                return r;
+            }
+        }
+
+        auto r = new site_record;
+        r->location = loc;
+        r->next = head_;
+        head_ = r;
+        return r;
+    }
+
+    mutex lock_;
+
+    site_record *head_{};
+
+    ::std::atomic<site_alias *> aliases_[alias_count]{};
+};
+
+// Points at the record of the vector's call site. Vectors that live during
+// constant evaluation are not recorded and keep a null record.
+class telemetry_probe
+{
+public:
+    constexpr explicit telemetry_probe(call_site site)
+    {
+        if (!::std::is_constant_evaluated())
+        {
+            record_ = site_registry::instance().find_or_add(site.location);
+            record_->vectors.fetch_add(1, ::std::memory_order_relaxed);
+        }
+    }
+
+    // A new buffer of capacity_bytes was installed; replaces tells whether it
+    // took over from an older buffer, from which bytes_moved were moved.
+    constexpr void on_allocate(bool replaces, ::std::size_t bytes_moved, ::std::size_t capacity_bytes) noexcept
+    {
+        if (!record_)
+        {
+            return;
+        }
+
+        record_->allocations.fetch_add(1, ::std::memory_order_relaxed);
+        if (replaces)
+        {
+            record_->reallocations.fetch_add(1, ::std::memory_order_relaxed);
+            record_->bytes_moved.fetch_add(bytes_moved, ::std::memory_order_relaxed);
+        }
+
+        auto peak = record_->peak_capacity_bytes.load(::std::memory_order_relaxed);
+        while (peak < capacity_bytes &&
+               !record_->peak_capacity_bytes.compare_exchange_weak(peak, capacity_bytes, ::std::memory_order_relaxed))
+        {
+        }
+    }
+
+    constexpr void on_destroy(::std::size_t wasted_bytes) noexcept
+    {
+        if (!record_)
+        {
+            return;
+        }
+
+        record_->destroyed.fetch_add(1, ::std::memory_order_relaxed);
+        record_->wasted_bytes.fetch_add(wasted_bytes, ::std::memory_order_relaxed);
+    }
+
+private:
+    site_record *record_{};
+};
+#else
+struct call_site
+{
+};
+
+// Stand-in for telemetry_probe when telemetry is disabled; being empty and
+// [[no_unique_address]], it adds neither space nor code to vector.
+struct telemetry_probe
+{
+    constexpr explicit telemetry_probe(call_site) noexcept
+    {
+    }
+
+    constexpr void on_allocate(bool, ::std::size_t, ::std::size_t) const noexcept
+    {
+    }
+
+    constexpr void on_destroy(::std::size_t) const noexcept
+    {
+    }
+};
+#endif
+} // namespace vector_detail
+
+// Calls f(const vector_site_stats &) for every recorded call site. Does
+// nothing when telemetry is disabled.
+template <typename F>
+void for_each_vector_site(F &&f)
+{
+#ifdef EVQOVV_UTILS_VECTOR_TELEMETRY
+    vector_detail::site_registry::instance().for_each(f);
+#else
+    (void)f;
+#endif
+}
+
+// Prints one line per call site, e.g. to pick reserve() sizes from the peak
+// capacity and the number of reallocations.
+inline void dump_vector_telemetry(::std::FILE *out = stderr)
+{
+    for_each_vector_site([out](const vector_site_stats &s) {
+        ::std::fprintf(out,
+                       "%s:%u:%u %s: vectors=%zu allocations=%zu reallocations=%zu bytes_moved=%zu "
+                       "peak_capacity_bytes=%zu destroyed=%zu wasted_bytes=%zu\n",
+                       s.file, s.line, s.column, s.function, s.vectors, s.allocations, s.reallocations,
+                       s.bytes_moved, s.peak_capacity_bytes, s.destroyed, s.wasted_bytes);
+    });
+}
+} // namespace utils
+} // namespace evqovv
\ No newline at end of file